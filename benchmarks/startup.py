@@ -0,0 +1,148 @@
+# -*- coding: utf-8 -*-
+#
+# The MIT License (MIT)
+#
+# Copyright 2013-2014 The MilkCat Project Developers
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# startup.py --- Created at 2026-10-17
+#
+# Measures wall time and peak RSS of milkcat_parser_new for every combination
+# of word segmenter, part-of-speech tagger and dependency parser. Each
+# construction runs in a fresh process, so no state of the library is kept
+# between measurements. The model files stay in the page cache of the system
+# though, so only the first run of a combination may be a cold start; it is
+# reported apart as seconds_first. With --drop-caches (Linux, needs root) the
+# page cache is dropped before every run, and every run is a cold start.
+# Results are written as JSON lines, one per combination:
+#
+#   python3 benchmarks/startup.py --model-path /usr/local/share/milkcat \
+#                                 --repeat 5 --output startup.jsonl
+#
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import platform
+import resource
+import subprocess
+import sys
+import time
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+sys.path.insert(0, ROOT)
+
+SEGMENTERS = ['MIXED', 'CRF', 'BIGRAM']
+POSTAGGERS = ['MIXED', 'CRF', 'HMM', 'NONE']
+DEPPARSERS = ['NONE', 'YAMADA', 'BEAMYAMADA']
+
+def PeakRSS():
+    ''' Peak resident set size of this process in bytes '''
+    maxrss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return maxrss if platform.system() == 'Darwin' else maxrss * 1024
+
+def Child(segmenter, postagger, depparser, model_path):
+    ''' Runs in the child process: constructs one parser and prints the
+    measurement as JSON '''
+    import milkcat_capi
+    options = milkcat_capi.milkcat_parseroptions_t()
+    milkcat_capi.milkcat_parseroptions_init(options)
+    options.word_segmenter = getattr(milkcat_capi, 'MC_SEGMENTER_' + segmenter)
+    options.part_of_speech_tagger = getattr(
+        milkcat_capi, 'MC_POSTAGGER_' + postagger)
+    options.dependency_parser = getattr(
+        milkcat_capi, 'MC_DEPPARSER_' + depparser)
+    if model_path:
+        options.model_path = model_path
+
+    rss_before = PeakRSS()
+    start = time.time()
+    parser = milkcat_capi.milkcat_parser_new(options)
+    elapsed = time.time() - start
+    result = {'seconds': elapsed,
+              'peak_rss_bytes': PeakRSS(),
+              'model_rss_bytes': PeakRSS() - rss_before}
+    if parser is None:
+        result['error'] = milkcat_capi.milkcat_last_error()
+    print(json.dumps(result))
+
+def DropCaches():
+    ''' Writes dirty pages back and drops the page cache of the system '''
+    subprocess.check_call(['sync'])
+    with open('/proc/sys/vm/drop_caches', 'w') as fd:
+        fd.write('3\n')
+
+def Measure(segmenter, postagger, depparser, args):
+    if args.drop_caches:
+        DropCaches()
+    command = [sys.executable, os.path.abspath(__file__), '--child',
+               segmenter, postagger, depparser]
+    if args.model_path:
+        command += ['--model-path', args.model_path]
+    output = subprocess.check_output(command, cwd = ROOT)
+    return json.loads(output.decode('utf-8').strip().splitlines()[-1])
+
+def Main():
+    parser = argparse.ArgumentParser(
+        description = 'Wall time and peak RSS of milkcat_parser_new')
+    parser.add_argument('--model-path', default = None)
+    parser.add_argument('--repeat', type = int, default = 3)
+    parser.add_argument('--output', default = None,
+                        help = 'write the JSON lines here instead of stdout')
+    parser.add_argument('--drop-caches', action = 'store_true',
+                        help = 'drop the page cache before every run (Linux, root)')
+    parser.add_argument('--child', nargs = 3, default = None,
+                        help = argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        Child(args.child[0], args.child[1], args.child[2], args.model_path)
+        return
+
+    output = open(args.output, 'w') if args.output else sys.stdout
+    for segmenter in SEGMENTERS:
+        for postagger in POSTAGGERS:
+            for depparser in DEPPARSERS:
+                runs = [Measure(segmenter, postagger, depparser, args)
+                        for _ in range(args.repeat)]
+                seconds = sorted(run['seconds'] for run in runs)
+                record = {
+                    'segmenter': segmenter,
+                    'postagger': postagger,
+                    'depparser': depparser,
+                    'repeat': args.repeat,
+                    'cold_cache': args.drop_caches,
+                    'seconds_first': round(runs[0]['seconds'], 6),
+                    'seconds_min': round(seconds[0], 6),
+                    'seconds_median': round(seconds[len(seconds) // 2], 6),
+                    'peak_rss_bytes': max(run['peak_rss_bytes'] for run in runs),
+                    'model_rss_bytes': max(run['model_rss_bytes'] for run in runs)}
+                errors = set(run['error'] for run in runs if 'error' in run)
+                if errors:
+                    record['error'] = '; '.join(sorted(errors))
+                print(json.dumps(record, sort_keys = True), file = output)
+                output.flush()
+    if output is not sys.stdout:
+        output.close()
+
+if __name__ == '__main__':
+    Main()
@@ -0,0 +1,111 @@
+# -*- coding: utf-8 -*-
+#
+# The MIT License (MIT)
+#
+# Copyright 2013-2014 The MilkCat Project Developers
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# thread_scaling.py --- Created at 2026-10-17
+#
+# Measures Parser.Predict throughput with one Parser per thread. Since the GIL
+# is released inside milkcat_parser_predict, documents per second should grow
+# almost linearly with the number of threads.
+#
+#   python3 benchmarks/thread_scaling.py --threads 1,2,4,8 corpus.txt
+#
+
+from __future__ import print_function
+
+import argparse
+import io
+import json
+import os
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..'))
+import pymilkcat
+
+def LoadCorpus(path, limit):
+    with io.open(path, encoding = 'utf-8') as fd:
+        lines = [line.strip() for line in fd if line.strip()]
+    return lines[:limit] if limit else lines
+
+def MakeOptions(args):
+    options = pymilkcat.ParserOptions()
+    if args.model_path:
+        options.SetModelPath(args.model_path)
+    if args.dependency:
+        options.UseBeamYamadaParser()
+    return options
+
+def RunOnce(corpus, num_threads, options):
+    parsers = [pymilkcat.Parser(options) for _ in range(num_threads)]
+    barrier = threading.Event()
+    tokens = [0] * num_threads
+
+    def Worker(index):
+        parser = parsers[index]
+        barrier.wait()
+        count = 0
+        for line in corpus[index::num_threads]:
+            count += len(parser.Predict(line))
+        tokens[index] = count
+
+    threads = [threading.Thread(target = Worker, args = (i, ))
+               for i in range(num_threads)]
+    for thread in threads:
+        thread.start()
+    start = time.time()
+    barrier.set()
+    for thread in threads:
+        thread.join()
+    return time.time() - start, sum(tokens)
+
+def Main():
+    parser = argparse.ArgumentParser(
+        description = "Parser.Predict throughput with one Parser per thread")
+    parser.add_argument('corpus', help = 'UTF-8 text file, one document per line')
+    parser.add_argument('--threads', default = '1,2,4,8')
+    parser.add_argument('--limit', type = int, default = 0)
+    parser.add_argument('--model-path', default = None)
+    parser.add_argument('--dependency', action = 'store_true',
+                        help = 'also run the BeamYamada dependency parser')
+    args = parser.parse_args()
+
+    corpus = LoadCorpus(args.corpus, args.limit)
+    options = MakeOptions(args)
+    baseline = None
+    for num_threads in [int(n) for n in args.threads.split(',')]:
+        elapsed, tokens = RunOnce(corpus, num_threads, options)
+        docs_per_second = len(corpus) / elapsed
+        if baseline is None:
+            baseline = docs_per_second
+        print(json.dumps({
+            'threads': num_threads,
+            'documents': len(corpus),
+            'tokens': tokens,
+            'seconds': round(elapsed, 4),
+            'documents_per_second': round(docs_per_second, 1),
+            'speedup': round(docs_per_second / baseline, 2)}))
+
+if __name__ == '__main__':
+    Main()
@@ -0,0 +1,72 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright 2013-2014 The MilkCat Project Developers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * milkcat_capi.i --- Created at 2026-10-17
+ *
+ * SWIG interface of the _milkcat_capi module: the C API of libmilkcat
+ * (milkcat.h) plus the functions of milkcat_capi_ext.h, implemented in
+ * milkcat_capi_ext.c. setup.py generates milkcat_capi_wrap.c and
+ * milkcat_capi.py from it with SWIG at build time, the same as
+ *
+ *   swig -python -I/usr/local/include milkcat_capi.i
+ *
+ * where -I points to the directory of milkcat.h. Neither file is kept in the
+ * repository.
+ */
+
+%module(threads="1") milkcat_capi
+
+%begin %{
+#include <Python.h>
+#if PY_VERSION_HEX >= 0x03070000
+/* Since Python 3.7 the GIL is created by the interpreter itself */
+#define SWIG_PYTHON_INITIALIZE_THREADS
+#endif
+%}
+
+%{
+#include <stdbool.h>
+#include <milkcat.h>
+#include "milkcat_capi_ext.h"
+%}
+
+/* Only the calls running the models release the GIL. The functions of
+   milkcat_capi_ext.h returning Python objects release it themselves. */
+%nothread;
+%thread milkcat_parser_new;
+%thread milkcat_parser_predict;
+%thread milkcat_batchengine_new;
+%thread milkcat_batchengine_destroy;
+
+/* The text of milkcat_parser_predict, the only const char * argument of the
+   API: str, bytes or any buffer-protocol object, read in place and kept
+   alive while the GIL is released. */
+%typemap(arginit) const char * "memset(&text$argnum, 0, sizeof(text$argnum));"
+%typemap(in) const char * (milkcat_text_t text) {
+  if (milkcat_text_acquire($input, &text) < 0) SWIG_fail;
+  $1 = ($1_ltype)text.cstr;
+}
+%typemap(freearg) const char * "milkcat_text_release(&text$argnum);"
+
+%include "milkcat.h"
+%include "milkcat_capi_ext.h"
@@ -0,0 +1,1400 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright 2013-2014 The MilkCat Project Developers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * milkcat_capi_ext.c --- Created at 2026-10-17
+ *
+ * See milkcat_capi_ext.h. Plain C on top of the Python C API and libmilkcat,
+ * no SWIG runtime, so it is compiled on its own next to the wrapper that
+ * SWIG generates from milkcat_capi.i.
+ */
+
+#include <Python.h>
+#include <pythread.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "milkcat_capi_ext.h"
+
+/* Returns the UTF-8 bytes [s, s + size) as a str (undecodable bytes are
+   escaped as surrogates) or as a byte string on Python 2, the same as the
+   strings returned by the SWIG wrappers. */
+static PyObject *
+milkcat_str(const char *s, size_t size)
+{
+#if PY_VERSION_HEX >= 0x03000000
+  return PyUnicode_DecodeUTF8(s, (Py_ssize_t)size, "surrogateescape");
+#else
+  return PyString_FromStringAndSize(s, (Py_ssize_t)size);
+#endif
+}
+
+static PyObject *
+milkcat_int(long value)
+{
+#if PY_VERSION_HEX >= 0x03000000
+  return PyLong_FromLong(value);
+#else
+  return PyInt_FromLong(value);
+#endif
+}
+
+/* -----------------------------------------------------------------------------
+ * milkcat_text_t: str uses its cached UTF-8 representation, bytes is used as
+ * is and any other buffer-protocol object (bytearray, memoryview, ...) is
+ * exported. Either way a reference (or the export) is held until
+ * milkcat_text_release, so the text stays alive and pinned while the GIL is
+ * released, even if the sequence it was taken from is changed meanwhile. Only
+ * a buffer that is not followed by a NUL byte is copied.
+ * ----------------------------------------------------------------------------- */
+
+/* Returns whether the byte after view is known to be the NUL terminator of a
+   bytes or bytearray object. */
+static int
+milkcat_text_is_terminated(PyObject *obj, Py_buffer *view)
+{
+  PyObject *base = obj;
+  const char *end = (const char *)view->buf + view->len;
+  if (PyMemoryView_Check(obj)) base = PyMemoryView_GET_BASE(obj);
+  if (!base) return 0;
+  if (PyBytes_Check(base))
+    return end == PyBytes_AS_STRING(base) + PyBytes_GET_SIZE(base);
+  if (PyByteArray_Check(base))
+    return end == PyByteArray_AS_STRING(base) + PyByteArray_GET_SIZE(base);
+  return 0;
+}
+
+int
+milkcat_text_acquire(PyObject *obj, milkcat_text_t *text)
+{
+  memset(text, 0, sizeof(milkcat_text_t));
+  if (PyUnicode_Check(obj)) {
+#if PY_VERSION_HEX >= 0x03030000
+    text->cstr = PyUnicode_AsUTF8AndSize(obj, &text->size);
+    if (!text->cstr) return -1;
+    Py_INCREF(obj);
+    text->owner = obj;
+#else
+    text->owner = PyUnicode_AsUTF8String(obj);
+    if (!text->owner) return -1;
+    text->cstr = PyBytes_AS_STRING(text->owner);
+    text->size = PyBytes_GET_SIZE(text->owner);
+#endif
+    return 0;
+  }
+  if (PyBytes_Check(obj)) {
+    text->cstr = PyBytes_AS_STRING(obj);
+    text->size = PyBytes_GET_SIZE(obj);
+    Py_INCREF(obj);
+    text->owner = obj;
+    return 0;
+  }
+  if (PyObject_CheckBuffer(obj)) {
+    if (PyObject_GetBuffer(obj, &text->view, PyBUF_SIMPLE) < 0) return -1;
+    text->has_view = 1;
+    text->size = text->view.len;
+    if (milkcat_text_is_terminated(obj, &text->view)) {
+      text->cstr = (const char *)text->view.buf;
+    } else {
+      text->copy = (char *)malloc(text->size + 1);
+      if (!text->copy) {
+        PyErr_NoMemory();
+        return -1;
+      }
+      memcpy(text->copy, text->view.buf, text->size);
+      text->copy[text->size] = '\0';
+      text->cstr = text->copy;
+    }
+    return 0;
+  }
+  PyErr_Format(PyExc_TypeError, "expected str, bytes or a buffer, not %.200s",
+               Py_TYPE(obj)->tp_name);
+  return -1;
+}
+
+void
+milkcat_text_release(milkcat_text_t *text)
+{
+  if (text->has_view) PyBuffer_Release(&text->view);
+  Py_XDECREF(text->owner);
+  free(text->copy);
+  memset(text, 0, sizeof(milkcat_text_t));
+}
+
+
+/* -----------------------------------------------------------------------------
+ * milkcat_tokenbuf_t: tokens drained from a milkcat_parseriterator_t. Words
+ * are kept back to back in one growable arena and tags are replaced by ids
+ * of a vocabulary local to the buffer. Draining does not touch any Python
+ * object, so it could run without the GIL; the Python objects are built
+ * afterwards.
+ * ----------------------------------------------------------------------------- */
+
+typedef struct {
+  size_t word;
+  size_t word_size;
+  int part_of_speech_tag;
+  int head;
+  int dependency_label;
+  bool is_begin_of_sentence;
+} milkcat_token_t;
+
+typedef struct {
+  milkcat_token_t *tokens;
+  size_t size;
+  size_t capacity;
+  char *arena;
+  size_t arena_size;
+  size_t arena_capacity;
+  char **tags;
+  size_t tags_size;
+  size_t tags_capacity;
+  int *tag_slots;
+  size_t tag_slots_size;
+} milkcat_tokenbuf_t;
+
+static void
+milkcat_tokenbuf_init(milkcat_tokenbuf_t *buf)
+{
+  memset(buf, 0, sizeof(milkcat_tokenbuf_t));
+}
+
+static void
+milkcat_tokenbuf_free(milkcat_tokenbuf_t *buf)
+{
+  size_t i;
+  for (i = 0; i < buf->tags_size; ++i) free(buf->tags[i]);
+  free(buf->tags);
+  free(buf->tag_slots);
+  free(buf->tokens);
+  free(buf->arena);
+  milkcat_tokenbuf_init(buf);
+}
+
+static size_t
+milkcat_tag_hash(const char *tag)
+{
+  size_t h = 2166136261u;
+  for (; *tag; ++tag) h = (h ^ (unsigned char)*tag) * 16777619u;
+  return h;
+}
+
+/* Local tag ids are stored into tag_slots (an open addressing table) as
+   id + 1, 0 marks an empty slot. */
+static int
+milkcat_tokenbuf_rehash_tags(milkcat_tokenbuf_t *buf)
+{
+  size_t size = buf->tag_slots_size ? buf->tag_slots_size * 2 : 64;
+  int *slots = (int *)calloc(size, sizeof(int));
+  size_t i, h;
+  if (!slots) return -1;
+  for (i = 0; i < buf->tags_size; ++i) {
+    for (h = milkcat_tag_hash(buf->tags[i]) & (size - 1); slots[h]; h = (h + 1) & (size - 1)) ;
+    slots[h] = (int)i + 1;
+  }
+  free(buf->tag_slots);
+  buf->tag_slots = slots;
+  buf->tag_slots_size = size;
+  return 0;
+}
+
+/* Stores the local id of tag into *id, -1 for a NULL tag. */
+static int
+milkcat_tokenbuf_tag(milkcat_tokenbuf_t *buf, const char *tag, int *id)
+{
+  size_t h, mask, len;
+  char *copy;
+  if (!tag) {
+    *id = -1;
+    return 0;
+  }
+  if (buf->tags_size * 2 >= buf->tag_slots_size) {
+    if (milkcat_tokenbuf_rehash_tags(buf) < 0) return -1;
+  }
+  mask = buf->tag_slots_size - 1;
+  for (h = milkcat_tag_hash(tag) & mask; buf->tag_slots[h]; h = (h + 1) & mask) {
+    if (strcmp(buf->tags[buf->tag_slots[h] - 1], tag) == 0) {
+      *id = buf->tag_slots[h] - 1;
+      return 0;
+    }
+  }
+  if (buf->tags_size == buf->tags_capacity) {
+    size_t capacity = buf->tags_capacity ? buf->tags_capacity * 2 : 32;
+    char **tags = (char **)realloc(buf->tags, capacity * sizeof(char *));
+    if (!tags) return -1;
+    buf->tags = tags;
+    buf->tags_capacity = capacity;
+  }
+  len = strlen(tag);
+  copy = (char *)malloc(len + 1);
+  if (!copy) return -1;
+  memcpy(copy, tag, len + 1);
+  buf->tags[buf->tags_size] = copy;
+  buf->tag_slots[h] = (int)buf->tags_size + 1;
+  *id = (int)buf->tags_size++;
+  return 0;
+}
+
+/* Copies the word into the arena, its offset and size are stored into
+   *offset and *size. */
+static int
+milkcat_tokenbuf_push_word(milkcat_tokenbuf_t *buf, const char *word,
+                           size_t *offset, size_t *size)
+{
+  size_t len = word ? strlen(word) : 0;
+  if (buf->arena_size + len > buf->arena_capacity) {
+    size_t capacity = buf->arena_capacity ? buf->arena_capacity * 2 : 4096;
+    char *arena;
+    while (capacity < buf->arena_size + len) capacity *= 2;
+    arena = (char *)realloc(buf->arena, capacity);
+    if (!arena) return -1;
+    buf->arena = arena;
+    buf->arena_capacity = capacity;
+  }
+  if (len) memcpy(buf->arena + buf->arena_size, word, len);
+  *offset = buf->arena_size;
+  *size = len;
+  buf->arena_size += len;
+  return 0;
+}
+
+/* Appends the token currently held by the fields of it to buf. */
+static int
+milkcat_tokenbuf_push(milkcat_tokenbuf_t *buf, milkcat_parseriterator_t *it)
+{
+  milkcat_token_t *token;
+  if (buf->size == buf->capacity) {
+    size_t capacity = buf->capacity ? buf->capacity * 2 : 256;
+    milkcat_token_t *tokens = (milkcat_token_t *)realloc(
+        buf->tokens, capacity * sizeof(milkcat_token_t));
+    if (!tokens) return -1;
+    buf->tokens = tokens;
+    buf->capacity = capacity;
+  }
+  token = buf->tokens + buf->size;
+  if (milkcat_tokenbuf_push_word(
+          buf, it->word, &token->word, &token->word_size) < 0 ||
+      milkcat_tokenbuf_tag(
+          buf, it->part_of_speech_tag, &token->part_of_speech_tag) < 0 ||
+      milkcat_tokenbuf_tag(
+          buf, it->dependency_label, &token->dependency_label) < 0) {
+    return -1;
+  }
+  token->head = it->head;
+  token->is_begin_of_sentence = it->is_begin_of_sentence;
+  buf->size++;
+  return 0;
+}
+
+/* Appends all the remaining tokens of it to buf. Safe to call without the
+   GIL. */
+static int
+milkcat_tokenbuf_drain(milkcat_tokenbuf_t *buf, milkcat_parseriterator_t *it)
+{
+  while (milkcat_parseriterator_next(it)) {
+    if (milkcat_tokenbuf_push(buf, it) < 0) return -1;
+  }
+  return 0;
+}
+
+/* Appends the tokens of the next sentence of it to buf. When pending is true,
+   the fields of it already hold the first token of that sentence, read by the
+   previous call. *more is set when another sentence follows, whose first
+   token is then held by it. Safe to call without the GIL. */
+static int
+milkcat_tokenbuf_drain_sentence(milkcat_tokenbuf_t *buf,
+                                milkcat_parseriterator_t *it,
+                                int pending, int *more)
+{
+  size_t begin = buf->size;
+  *more = 0;
+  if (pending && milkcat_tokenbuf_push(buf, it) < 0) return -1;
+  while (milkcat_parseriterator_next(it)) {
+    if (it->is_begin_of_sentence && buf->size > begin) {
+      *more = 1;
+      break;
+    }
+    if (milkcat_tokenbuf_push(buf, it) < 0) return -1;
+  }
+  return 0;
+}
+
+/* Returns a new reference to the decoded str of every local tag of buf, so that
+   each distinct tag is decoded only once and shared by all the tuples. */
+static PyObject **
+milkcat_tokenbuf_tag_objects(milkcat_tokenbuf_t *buf)
+{
+  PyObject **tags = (PyObject **)calloc(buf->tags_size + 1, sizeof(PyObject *));
+  size_t i;
+  if (!tags) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  for (i = 0; i < buf->tags_size; ++i) {
+    tags[i] = milkcat_str(buf->tags[i], strlen(buf->tags[i]));
+    if (!tags[i]) {
+      while (i--) Py_DECREF(tags[i]);
+      free(tags);
+      return NULL;
+    }
+  }
+  return tags;
+}
+
+static void
+milkcat_tokenbuf_release_tag_objects(milkcat_tokenbuf_t *buf, PyObject **tags)
+{
+  size_t i;
+  for (i = 0; i < buf->tags_size; ++i) Py_DECREF(tags[i]);
+  free(tags);
+}
+
+/* Stores the tokens in [begin, end) as (word, part_of_speech_tag, head,
+   dependency_label, is_begin_of_sentence) tuples into list, starting at
+   index offset. Returns -1 with a Python exception set on failure. */
+static int
+milkcat_tokenbuf_fill_list(milkcat_tokenbuf_t *buf, PyObject **tags,
+                           size_t begin, size_t end,
+                           PyObject *list, Py_ssize_t offset)
+{
+  PyObject *item, *tag;
+  milkcat_token_t *token;
+  size_t i;
+  for (i = begin; i < end; ++i) {
+    token = buf->tokens + i;
+    item = PyTuple_New(5);
+    if (!item) return -1;
+    PyList_SET_ITEM(list, offset + (Py_ssize_t)(i - begin), item);
+    PyTuple_SET_ITEM(item, 0, milkcat_str(buf->arena + token->word, token->word_size));
+    tag = token->part_of_speech_tag < 0 ? Py_None : tags[token->part_of_speech_tag];
+    Py_INCREF(tag);
+    PyTuple_SET_ITEM(item, 1, tag);
+    PyTuple_SET_ITEM(item, 2, milkcat_int(token->head));
+    tag = token->dependency_label < 0 ? Py_None : tags[token->dependency_label];
+    Py_INCREF(tag);
+    PyTuple_SET_ITEM(item, 3, tag);
+    PyTuple_SET_ITEM(item, 4, PyBool_FromLong(token->is_begin_of_sentence));
+    if (PyErr_Occurred()) return -1;
+  }
+  return 0;
+}
+
+/* Returns the tokens in [begin, end) as a list of tuples. */
+static PyObject *
+milkcat_tokenbuf_as_list(milkcat_tokenbuf_t *buf, size_t begin, size_t end)
+{
+  PyObject **tags = milkcat_tokenbuf_tag_objects(buf);
+  PyObject *list;
+  if (!tags) return NULL;
+  list = PyList_New((Py_ssize_t)(end - begin));
+  if (list && milkcat_tokenbuf_fill_list(buf, tags, begin, end, list, 0) < 0) {
+    Py_DECREF(list);
+    list = NULL;
+  }
+  milkcat_tokenbuf_release_tag_objects(buf, tags);
+  return list;
+}
+
+/* Returns the words of all the tokens of buf as a list of str. */
+static PyObject *
+milkcat_tokenbuf_as_words(milkcat_tokenbuf_t *buf)
+{
+  PyObject *list = PyList_New((Py_ssize_t)buf->size);
+  PyObject *word;
+  size_t i;
+  if (!list) return NULL;
+  for (i = 0; i < buf->size; ++i) {
+    word = milkcat_str(buf->arena + buf->tokens[i].word,
+                       buf->tokens[i].word_size);
+    if (!word) {
+      Py_DECREF(list);
+      return NULL;
+    }
+    PyList_SET_ITEM(list, (Py_ssize_t)i, word);
+  }
+  return list;
+}
+
+
+/* -----------------------------------------------------------------------------
+ * Tag vocabulary: maps part-of-speech tags and dependency labels to ids that
+ * are stable within a process. The Chinese Treebank tags and the common
+ * dependency labels come first and always have the same ids, any other tag
+ * reported by the models is appended when first seen. Not thread safe, only
+ * used while holding the GIL.
+ * ----------------------------------------------------------------------------- */
+
+static const char *milkcat_builtin_tags[] = {
+  "AD", "AS", "BA", "CC", "CD", "CS", "DEC", "DEG", "DER", "DEV", "DT",
+  "ETC", "FW", "IJ", "JJ", "LB", "LC", "M", "MSP", "NN", "NR", "NT", "OD",
+  "ON", "P", "PN", "PU", "SB", "SP", "VA", "VC", "VE", "VV",
+  "ROOT", "SBJ", "OBJ", "NMOD", "VMOD", "AMOD", "PMOD", "PRD", "DEP", "SBAR",
+  NULL
+};
+
+#define MILKCAT_BUILTIN_TAGS_SIZE \
+  (sizeof(milkcat_builtin_tags) / sizeof(milkcat_builtin_tags[0]) - 1)
+
+static char **milkcat_tags = 0;
+static size_t milkcat_tags_size = 0;
+static size_t milkcat_tags_capacity = 0;
+
+/* Returns the id of tag in the vocabulary, or -1 when out of memory. */
+static int
+milkcat_tag_id(const char *tag)
+{
+  size_t i, len;
+  char *copy;
+  for (i = 0; milkcat_builtin_tags[i]; ++i) {
+    if (strcmp(milkcat_builtin_tags[i], tag) == 0) return (int)i;
+  }
+  for (i = 0; i < milkcat_tags_size; ++i) {
+    if (strcmp(milkcat_tags[i], tag) == 0) return (int)(i + MILKCAT_BUILTIN_TAGS_SIZE);
+  }
+  if (milkcat_tags_size == milkcat_tags_capacity) {
+    size_t capacity = milkcat_tags_capacity ? milkcat_tags_capacity * 2 : 16;
+    char **tags = (char **)realloc(milkcat_tags, capacity * sizeof(char *));
+    if (!tags) return -1;
+    milkcat_tags = tags;
+    milkcat_tags_capacity = capacity;
+  }
+  len = strlen(tag);
+  copy = (char *)malloc(len + 1);
+  if (!copy) return -1;
+  memcpy(copy, tag, len + 1);
+  milkcat_tags[milkcat_tags_size] = copy;
+  return (int)(milkcat_tags_size++ + MILKCAT_BUILTIN_TAGS_SIZE);
+}
+
+PyObject *
+milkcat_tag_vocabulary(void)
+{
+  PyObject *list = PyList_New(MILKCAT_BUILTIN_TAGS_SIZE + milkcat_tags_size);
+  PyObject *tag;
+  const char *name;
+  size_t i;
+  if (!list) return NULL;
+  for (i = 0; i < MILKCAT_BUILTIN_TAGS_SIZE + milkcat_tags_size; ++i) {
+    name = i < MILKCAT_BUILTIN_TAGS_SIZE ?
+           milkcat_builtin_tags[i] :
+           milkcat_tags[i - MILKCAT_BUILTIN_TAGS_SIZE];
+    tag = milkcat_str(name, strlen(name));
+    if (!tag) {
+      Py_DECREF(list);
+      return NULL;
+    }
+    PyList_SET_ITEM(list, i, tag);
+  }
+  return list;
+}
+
+/* Layout of the records of a token in milkcat_tokenbuf_as_packed */
+#define MILKCAT_PACKED_WORD 0
+#define MILKCAT_PACKED_WORD_SIZE 1
+#define MILKCAT_PACKED_PART_OF_SPEECH_TAG 2
+#define MILKCAT_PACKED_HEAD 3
+#define MILKCAT_PACKED_DEPENDENCY_LABEL 4
+#define MILKCAT_PACKED_IS_BEGIN_OF_SENTENCE 5
+#define MILKCAT_PACKED_FIELDS 6
+
+/* Returns the tokens as a (words, records) tuple of two bytes objects. words
+   holds the UTF-8 words back to back, records holds MILKCAT_PACKED_FIELDS
+   native ints for each token: the offset and size of the word in words, the
+   part-of-speech tag id, the head, the dependency label id (tag ids are from
+   the tag vocabulary, -1 for none) and whether it begins a sentence. */
+static PyObject *
+milkcat_tokenbuf_as_packed(milkcat_tokenbuf_t *buf)
+{
+  PyObject *words = 0;
+  PyObject *records = 0;
+  int *ids = 0;
+  int *record;
+  milkcat_token_t *token;
+  size_t i;
+  ids = (int *)calloc(buf->tags_size + 1, sizeof(int));
+  if (!ids) return PyErr_NoMemory();
+  for (i = 0; i < buf->tags_size; ++i) {
+    ids[i] = milkcat_tag_id(buf->tags[i]);
+    if (ids[i] < 0) {
+      free(ids);
+      return PyErr_NoMemory();
+    }
+  }
+  words = PyBytes_FromStringAndSize(buf->arena, buf->arena_size);
+  records = PyBytes_FromStringAndSize(NULL, buf->size * MILKCAT_PACKED_FIELDS * sizeof(int));
+  if (!words || !records) {
+    free(ids);
+    Py_XDECREF(words);
+    Py_XDECREF(records);
+    return NULL;
+  }
+  record = (int *)PyBytes_AS_STRING(records);
+  for (i = 0; i < buf->size; ++i, record += MILKCAT_PACKED_FIELDS) {
+    token = buf->tokens + i;
+    record[MILKCAT_PACKED_WORD] = (int)token->word;
+    record[MILKCAT_PACKED_WORD_SIZE] = (int)token->word_size;
+    record[MILKCAT_PACKED_PART_OF_SPEECH_TAG] =
+        token->part_of_speech_tag < 0 ? -1 : ids[token->part_of_speech_tag];
+    record[MILKCAT_PACKED_HEAD] = token->head;
+    record[MILKCAT_PACKED_DEPENDENCY_LABEL] =
+        token->dependency_label < 0 ? -1 : ids[token->dependency_label];
+    record[MILKCAT_PACKED_IS_BEGIN_OF_SENTENCE] = token->is_begin_of_sentence;
+  }
+  free(ids);
+  return Py_BuildValue("(NN)", words, records);
+}
+
+
+/* -----------------------------------------------------------------------------
+ * Token spans: the library reports words but not where they are, so each word
+ * is located in the original text starting from the end of the previous one.
+ * Whitespace the segmenter skipped is passed over first, whatever its length,
+ * then other skipped characters are searched over, at most
+ * MILKCAT_SPAN_WINDOW bytes ahead; a word that could not be found (e.g. one
+ * normalized by the models) gets the span (-1, -1).
+ * ----------------------------------------------------------------------------- */
+
+#define MILKCAT_SPAN_WINDOW 256
+
+typedef struct {
+  const char *text;
+  const char *end;
+  const char *cursor;
+  int position;
+  int codepoints;
+} milkcat_spancursor_t;
+
+typedef struct {
+  int *spans;
+  size_t size;
+  size_t capacity;
+} milkcat_spanbuf_t;
+
+static void
+milkcat_spancursor_init(milkcat_spancursor_t *cursor, const char *text,
+                        size_t size, int codepoints)
+{
+  cursor->text = text;
+  cursor->end = text + size;
+  cursor->cursor = text;
+  cursor->position = 0;
+  cursor->codepoints = codepoints;
+}
+
+/* Returns the size of the whitespace character at p, 0 if there is none. */
+static size_t
+milkcat_whitespace(const char *p, const char *end)
+{
+  const unsigned char *u = (const unsigned char *)p;
+  if (p >= end) return 0;
+  if (u[0] == ' ' || (u[0] >= '\t' && u[0] <= '\r')) return 1;
+  /* U+00A0 no-break space */
+  if (end - p >= 2 && u[0] == 0xC2 && u[1] == 0xA0) return 2;
+  /* U+3000 ideographic space */
+  if (end - p >= 3 && u[0] == 0xE3 && u[1] == 0x80 && u[2] == 0x80) return 3;
+  return 0;
+}
+
+static const char *
+milkcat_find_word(const char *cursor, const char *end, const char *word, size_t len)
+{
+  const char *last;
+  size_t space;
+  if (!milkcat_whitespace(word, word + len)) {
+    while ((space = milkcat_whitespace(cursor, end)) != 0) cursor += space;
+  }
+  last = end - len;
+  if (cursor + MILKCAT_SPAN_WINDOW < last) last = cursor + MILKCAT_SPAN_WINDOW;
+  for (; cursor <= last; ++cursor) {
+    if (*cursor == *word && memcmp(cursor, word, len) == 0) return cursor;
+  }
+  return NULL;
+}
+
+/* Locates the next word and stores its (start, end) span into span, in bytes
+   or in code points of the text. */
+static void
+milkcat_spancursor_next(milkcat_spancursor_t *cursor, const char *word,
+                        size_t len, int *span)
+{
+  const char *start = len ? milkcat_find_word(cursor->cursor, cursor->end, word, len) : NULL;
+  if (!start) {
+    span[0] = span[1] = -1;
+  } else if (cursor->codepoints) {
+    for (; cursor->cursor < start; ++cursor->cursor) {
+      cursor->position += (*cursor->cursor & 0xC0) != 0x80;
+    }
+    span[0] = cursor->position;
+    for (; cursor->cursor < start + len; ++cursor->cursor) {
+      cursor->position += (*cursor->cursor & 0xC0) != 0x80;
+    }
+    span[1] = cursor->position;
+  } else {
+    cursor->cursor = start + len;
+    span[0] = (int)(start - cursor->text);
+    span[1] = (int)(cursor->cursor - cursor->text);
+  }
+}
+
+/* Appends the (start, end) span of all the remaining tokens of it to buf.
+   Safe to call without the GIL. */
+static int
+milkcat_spanbuf_drain(milkcat_spanbuf_t *buf, milkcat_parseriterator_t *it,
+                      const char *text, size_t size, int codepoints)
+{
+  milkcat_spancursor_t cursor;
+  milkcat_spancursor_init(&cursor, text, size, codepoints);
+  while (milkcat_parseriterator_next(it)) {
+    if (buf->size + 2 > buf->capacity) {
+      size_t capacity = buf->capacity ? buf->capacity * 2 : 512;
+      int *spans = (int *)realloc(buf->spans, capacity * sizeof(int));
+      if (!spans) return -1;
+      buf->spans = spans;
+      buf->capacity = capacity;
+    }
+    milkcat_spancursor_next(&cursor, it->word, it->word ? strlen(it->word) : 0,
+                            buf->spans + buf->size);
+    buf->size += 2;
+  }
+  return 0;
+}
+
+
+/* -----------------------------------------------------------------------------
+ * milkcat_array_t: a caller supplied, writable, C contiguous integer array
+ * (array.array, numpy.ndarray or any other buffer-protocol object), filled in
+ * place by milkcat_parser_predict_into.
+ * ----------------------------------------------------------------------------- */
+
+typedef struct {
+  Py_buffer view;
+  int has_view;
+  int is_signed;
+  Py_ssize_t size;
+} milkcat_array_t;
+
+/* Exports obj, which should be None or an array of integers whose item size
+   is between min_itemsize and max_itemsize. Sets a Python exception and
+   returns -1 on failure. */
+static int
+milkcat_array_acquire(PyObject *obj, milkcat_array_t *array, const char *name,
+                      Py_ssize_t min_itemsize, Py_ssize_t max_itemsize)
+{
+  const int one = 1;
+  const char *format;
+  memset(array, 0, sizeof(milkcat_array_t));
+  if (obj == Py_None) return 0;
+  if (PyObject_GetBuffer(obj, &array->view, PyBUF_CONTIG | PyBUF_FORMAT) < 0) return -1;
+  array->has_view = 1;
+  format = array->view.format ? array->view.format : "B";
+  if (*format == '@' || *format == '=' || *format == (*(const char *)&one ? '<' : '>')) ++format;
+  if (format[0] == '\0' || format[1] != '\0' || !strchr("bBhHiIlLqQ", format[0]) ||
+      array->view.itemsize < min_itemsize || array->view.itemsize > max_itemsize) {
+    PyErr_Format(PyExc_TypeError, "%s should be an array of %d to %d byte native integers",
+                 name, (int)min_itemsize, (int)max_itemsize);
+    return -1;
+  }
+  array->is_signed = format[0] >= 'a';
+  array->size = array->view.len / array->view.itemsize;
+  return 0;
+}
+
+/* Returns the largest tag id that fits into the items of array. -1 marks a
+   missing tag, so it takes all the bits of an unsigned item. */
+static int
+milkcat_array_max_id(milkcat_array_t *array)
+{
+  int bits = 8 * (int)array->view.itemsize;
+  if (bits >= 32) return INT_MAX;
+  return array->is_signed ? (1 << (bits - 1)) - 1 : (1 << bits) - 2;
+}
+
+static void
+milkcat_array_release(milkcat_array_t *array)
+{
+  if (array->has_view) PyBuffer_Release(&array->view);
+  memset(array, 0, sizeof(milkcat_array_t));
+}
+
+static void
+milkcat_array_set(milkcat_array_t *array, Py_ssize_t index, int value)
+{
+  char *item = (char *)array->view.buf + index * array->view.itemsize;
+  switch (array->view.itemsize) {
+    case 1: *(signed char *)item = (signed char)value; break;
+    case 2: *(short *)item = (short)value; break;
+    case 4: *(int *)item = value; break;
+    default: *(long long *)item = value; break;
+  }
+}
+
+
+/* -----------------------------------------------------------------------------
+ * milkcat_batchengine_t: a pool of native worker threads, each one with its
+ * own parser, predicting batches of texts. Each text is a unit, or, when
+ * asked for, texts are cut into units of whole sentences at the terminators
+ * of milkcat_sentence_end. The units are split into one contiguous range per
+ * worker, used as a deque: a worker takes units from the front of its own
+ * range and, once it is empty, steals from the back of the ranges of the
+ * other workers, so that the units are spread over all the workers. Worker
+ * threads never touch Python objects.
+ * ----------------------------------------------------------------------------- */
+
+/* Consecutive sentences of a text are merged into one unit up to this many
+   bytes, so that short sentences do not pay for a predict call each. */
+#define MILKCAT_UNIT_SIZE 256
+
+typedef struct {
+  size_t text;
+  size_t offset;
+  int worker;
+  size_t begin;
+  size_t end;
+} milkcat_unit_t;
+
+typedef struct {
+  milkcat_batchengine_t *engine;
+  int index;
+  milkcat_parser_t *parser;
+  milkcat_parseriterator_t *iterator;
+  PyThread_type_lock wake;
+  PyThread_type_lock lock;
+  size_t head;
+  size_t tail;
+  milkcat_tokenbuf_t tokens;
+  int status;
+} milkcat_worker_t;
+
+struct milkcat_batchengine_t {
+  milkcat_worker_t *workers;
+  int size;
+  int started;
+  int shutdown;
+  int running;
+  PyThread_type_lock running_lock;
+  PyThread_type_lock done;
+  PyThread_type_lock busy;
+  milkcat_unit_t *units;
+  size_t units_size;
+  char *arena;
+};
+
+/* Returns the size of the sentence terminator at p, 0 if there is none. Only
+   a newline and the full width terminators are taken, ASCII '!' and '?' are
+   too often part of a sentence (URLs, names such as "Yahoo!"). */
+static size_t
+milkcat_sentence_end(const char *p)
+{
+  const unsigned char *u = (const unsigned char *)p;
+  if (u[0] == '\n') return 1;
+  /* U+3002 '。' */
+  if (u[0] == 0xE3 && u[1] == 0x80 && u[2] == 0x82) return 3;
+  /* U+FF01 '！' and U+FF1F '？' */
+  if (u[0] == 0xEF && u[1] == 0xBC && (u[2] == 0x81 || u[2] == 0x9F)) return 3;
+  return 0;
+}
+
+/* Cuts text into units when split is set, or else makes it a single unit.
+   With units == NULL only counts them, otherwise also copies each unit, NUL
+   terminated, to arena + *arena_size. */
+static size_t
+milkcat_split_units(const char *text, size_t size, size_t index, int split,
+                    milkcat_unit_t *units, char *arena, size_t *arena_size)
+{
+  const char *begin = text;
+  const char *p = text;
+  const char *end = text + size;
+  size_t count = 0;
+  size_t len;
+  while (begin < end) {
+    if (!split) p = end;
+    for (; p < end; ++p) {
+      len = milkcat_sentence_end(p);
+      if (len && p + len - begin >= MILKCAT_UNIT_SIZE) {
+        p += len;
+        break;
+      }
+      if (len) p += len - 1;
+    }
+    if (units) {
+      units[count].text = index;
+      units[count].offset = *arena_size;
+      memcpy(arena + *arena_size, begin, p - begin);
+      arena[*arena_size + (p - begin)] = '\0';
+      *arena_size += p - begin + 1;
+    }
+    ++count;
+    begin = p;
+  }
+  return count;
+}
+
+static int
+milkcat_worker_take(milkcat_worker_t *worker, size_t *unit)
+{
+  int found = 0;
+  PyThread_acquire_lock(worker->lock, WAIT_LOCK);
+  if (worker->head < worker->tail) {
+    *unit = worker->head++;
+    found = 1;
+  }
+  PyThread_release_lock(worker->lock);
+  return found;
+}
+
+static int
+milkcat_worker_steal(milkcat_worker_t *victim, size_t *unit)
+{
+  int found = 0;
+  PyThread_acquire_lock(victim->lock, WAIT_LOCK);
+  if (victim->head < victim->tail) {
+    *unit = --victim->tail;
+    found = 1;
+  }
+  PyThread_release_lock(victim->lock);
+  return found;
+}
+
+static void
+milkcat_worker_run(milkcat_worker_t *worker)
+{
+  milkcat_batchengine_t *engine = worker->engine;
+  milkcat_unit_t *unit;
+  size_t index;
+  int i, found;
+  for (;;) {
+    found = milkcat_worker_take(worker, &index);
+    for (i = 1; !found && i < engine->size; ++i) {
+      found = milkcat_worker_steal(
+          engine->workers + (worker->index + i) % engine->size, &index);
+    }
+    if (!found) return;
+    unit = engine->units + index;
+    milkcat_parser_predict(worker->parser, worker->iterator, engine->arena + unit->offset);
+    unit->worker = worker->index;
+    unit->begin = worker->tokens.size;
+    if (milkcat_tokenbuf_drain(&worker->tokens, worker->iterator) < 0) {
+      worker->status = -1;
+    }
+    unit->end = worker->tokens.size;
+  }
+}
+
+/* Called by a worker once it is done with a batch. The engine may be freed
+   as soon as the last worker releases engine->done, so nothing of it must
+   be touched after that. */
+static void
+milkcat_batchengine_finish(milkcat_batchengine_t *engine)
+{
+  PyThread_type_lock done = engine->done;
+  int last;
+  PyThread_acquire_lock(engine->running_lock, WAIT_LOCK);
+  last = --engine->running == 0;
+  PyThread_release_lock(engine->running_lock);
+  if (last) PyThread_release_lock(done);
+}
+
+static void
+milkcat_worker_main(void *arg)
+{
+  milkcat_worker_t *worker = (milkcat_worker_t *)arg;
+  milkcat_batchengine_t *engine = worker->engine;
+  for (;;) {
+    PyThread_acquire_lock(worker->wake, WAIT_LOCK);
+    if (engine->shutdown) break;
+    milkcat_worker_run(worker);
+    milkcat_batchengine_finish(engine);
+  }
+  milkcat_batchengine_finish(engine);
+}
+
+/* Wakes up all the workers and waits until they are done. Called without the
+   GIL while holding engine->busy. */
+static void
+milkcat_batchengine_wake(milkcat_batchengine_t *engine)
+{
+  int i;
+  engine->running = engine->started;
+  if (!engine->running) return;
+  for (i = 0; i < engine->started; ++i) PyThread_release_lock(engine->workers[i].wake);
+  PyThread_acquire_lock(engine->done, WAIT_LOCK);
+}
+
+void
+milkcat_batchengine_destroy(milkcat_batchengine_t *engine)
+{
+  int i;
+  milkcat_worker_t *worker;
+  if (engine->busy) PyThread_acquire_lock(engine->busy, WAIT_LOCK);
+  engine->shutdown = 1;
+  milkcat_batchengine_wake(engine);
+  for (i = 0; engine->workers && i < engine->size; ++i) {
+    worker = engine->workers + i;
+    if (worker->parser) milkcat_parser_destroy(worker->parser);
+    if (worker->iterator) milkcat_parseriterator_destroy(worker->iterator);
+    if (worker->wake) PyThread_free_lock(worker->wake);
+    if (worker->lock) PyThread_free_lock(worker->lock);
+    milkcat_tokenbuf_free(&worker->tokens);
+  }
+  if (engine->running_lock) PyThread_free_lock(engine->running_lock);
+  if (engine->done) PyThread_free_lock(engine->done);
+  if (engine->busy) {
+    PyThread_release_lock(engine->busy);
+    PyThread_free_lock(engine->busy);
+  }
+  free(engine->workers);
+  free(engine->units);
+  free(engine->arena);
+  free(engine);
+}
+
+milkcat_batchengine_t *
+milkcat_batchengine_new(milkcat_parseroptions_t *options, int size)
+{
+  milkcat_batchengine_t *engine;
+  milkcat_worker_t *worker;
+  int i;
+  if (size < 1) size = 1;
+  engine = (milkcat_batchengine_t *)calloc(1, sizeof(milkcat_batchengine_t));
+  if (!engine) return NULL;
+  engine->size = size;
+  engine->workers = (milkcat_worker_t *)calloc(size, sizeof(milkcat_worker_t));
+  engine->running_lock = PyThread_allocate_lock();
+  engine->done = PyThread_allocate_lock();
+  engine->busy = PyThread_allocate_lock();
+  if (!engine->workers || !engine->running_lock || !engine->done || !engine->busy) goto fail;
+  PyThread_acquire_lock(engine->done, WAIT_LOCK);
+  for (i = 0; i < size; ++i) {
+    worker = engine->workers + i;
+    worker->engine = engine;
+    worker->index = i;
+    milkcat_tokenbuf_init(&worker->tokens);
+    worker->parser = milkcat_parser_new(options);
+    worker->iterator = milkcat_parseriterator_new();
+    worker->wake = PyThread_allocate_lock();
+    worker->lock = PyThread_allocate_lock();
+    if (!worker->parser || !worker->iterator || !worker->wake || !worker->lock) goto fail;
+    PyThread_acquire_lock(worker->wake, WAIT_LOCK);
+  }
+  for (i = 0; i < size; ++i) {
+    if (PyThread_start_new_thread(milkcat_worker_main, engine->workers + i) == (unsigned long)-1) goto fail;
+    engine->started++;
+  }
+  return engine;
+fail:
+  milkcat_batchengine_destroy(engine);
+  return NULL;
+}
+
+/* Hands the texts out to the workers, each one as a single unit unless split
+   is set. Called without the GIL while holding engine->busy. */
+static int
+milkcat_batchengine_run(milkcat_batchengine_t *engine,
+                        milkcat_text_t *texts, size_t size, int split)
+{
+  size_t i, arena_size = 0, count = 0, per_worker;
+  milkcat_worker_t *worker;
+  for (i = 0; i < size; ++i) {
+    count += milkcat_split_units(texts[i].cstr, (size_t)texts[i].size, i, split, NULL, NULL, NULL);
+    arena_size += (size_t)texts[i].size + 1;
+  }
+  free(engine->units);
+  free(engine->arena);
+  engine->units = (milkcat_unit_t *)calloc(count + 1, sizeof(milkcat_unit_t));
+  engine->arena = (char *)malloc(arena_size + count + 1);
+  engine->units_size = count;
+  if (!engine->units || !engine->arena) return -1;
+  arena_size = count = 0;
+  for (i = 0; i < size; ++i) {
+    count += milkcat_split_units(texts[i].cstr, (size_t)texts[i].size, i, split,
+                                 engine->units + count, engine->arena, &arena_size);
+  }
+  per_worker = (count + engine->started - 1) / engine->started;
+  for (i = 0; i < (size_t)engine->started; ++i) {
+    worker = engine->workers + i;
+    worker->head = i * per_worker < count ? i * per_worker : count;
+    worker->tail = worker->head + per_worker < count ? worker->head + per_worker : count;
+    worker->status = 0;
+    worker->tokens.size = 0;
+    worker->tokens.arena_size = 0;
+  }
+  milkcat_batchengine_wake(engine);
+  for (i = 0; i < (size_t)engine->started; ++i) {
+    if (engine->workers[i].status < 0) return engine->workers[i].status;
+  }
+  return 0;
+}
+
+/* Returns one list of tuples for each of the size texts of the last run. */
+static PyObject *
+milkcat_batchengine_results(milkcat_batchengine_t *engine, size_t size)
+{
+  PyObject ***tags = (PyObject ***)calloc(engine->started + 1, sizeof(PyObject **));
+  PyObject *results = 0, *list;
+  milkcat_unit_t *unit, *first;
+  size_t i, text, count;
+  Py_ssize_t offset;
+  if (!tags) return PyErr_NoMemory();
+  for (i = 0; i < (size_t)engine->started; ++i) {
+    tags[i] = milkcat_tokenbuf_tag_objects(&engine->workers[i].tokens);
+    if (!tags[i]) goto fail;
+  }
+  results = PyList_New((Py_ssize_t)size);
+  if (!results) goto fail;
+  unit = engine->units;
+  for (text = 0; text < size; ++text) {
+    count = 0;
+    for (first = unit; unit < engine->units + engine->units_size && unit->text == text; ++unit) {
+      count += unit->end - unit->begin;
+    }
+    list = PyList_New((Py_ssize_t)count);
+    if (!list) goto fail;
+    PyList_SET_ITEM(results, (Py_ssize_t)text, list);
+    for (offset = 0; first < unit; offset += (Py_ssize_t)(first->end - first->begin), ++first) {
+      if (milkcat_tokenbuf_fill_list(&engine->workers[first->worker].tokens, tags[first->worker],
+                                     first->begin, first->end, list, offset) < 0) {
+        goto fail;
+      }
+    }
+  }
+  for (i = 0; i < (size_t)engine->started; ++i) {
+    milkcat_tokenbuf_release_tag_objects(&engine->workers[i].tokens, tags[i]);
+  }
+  free(tags);
+  return results;
+fail:
+  for (i = 0; i < (size_t)engine->started; ++i) {
+    if (tags[i]) milkcat_tokenbuf_release_tag_objects(&engine->workers[i].tokens, tags[i]);
+  }
+  free(tags);
+  Py_XDECREF(results);
+  return NULL;
+}
+
+
+/* -----------------------------------------------------------------------------
+ * Functions wrapped by milkcat_capi.i
+ * ----------------------------------------------------------------------------- */
+
+/* Takes the text of every item of the sequence texts into a new array of
+   *size texts, released by milkcat_texts_release. A new reference to the
+   sequence is stored into *seq, the items are only borrowed from it. */
+static milkcat_text_t *
+milkcat_texts_acquire(PyObject *texts, PyObject **seq, Py_ssize_t *size)
+{
+  milkcat_text_t *array;
+  Py_ssize_t i;
+  *seq = PySequence_Fast(texts, "texts should be a sequence of strings");
+  if (!*seq) return NULL;
+  *size = PySequence_Fast_GET_SIZE(*seq);
+  array = (milkcat_text_t *)calloc(*size + 1, sizeof(milkcat_text_t));
+  if (!array) {
+    Py_CLEAR(*seq);
+    PyErr_NoMemory();
+    return NULL;
+  }
+  for (i = 0; i < *size; ++i) {
+    if (milkcat_text_acquire(PySequence_Fast_GET_ITEM(*seq, i), &array[i]) < 0) {
+      while (i--) milkcat_text_release(&array[i]);
+      free(array);
+      Py_CLEAR(*seq);
+      return NULL;
+    }
+  }
+  return array;
+}
+
+static void
+milkcat_texts_release(milkcat_text_t *texts, PyObject *seq, Py_ssize_t size)
+{
+  Py_ssize_t i;
+  for (i = 0; i < size; ++i) milkcat_text_release(&texts[i]);
+  free(texts);
+  Py_DECREF(seq);
+}
+
+PyObject *
+milkcat_parser_predict_batch(milkcat_parser_t *parser,
+                             milkcat_parseriterator_t *iterator,
+                             PyObject *texts)
+{
+  PyObject *seq, *result = NULL, *list;
+  Py_ssize_t size, i;
+  milkcat_text_t *array;
+  size_t *bounds;
+  milkcat_tokenbuf_t tokens;
+  int status = 0;
+  array = milkcat_texts_acquire(texts, &seq, &size);
+  if (!array) return NULL;
+  bounds = (size_t *)calloc(size + 1, sizeof(size_t));
+  if (!bounds) {
+    milkcat_texts_release(array, seq, size);
+    return PyErr_NoMemory();
+  }
+  milkcat_tokenbuf_init(&tokens);
+  Py_BEGIN_ALLOW_THREADS
+  for (i = 0; i < size && status == 0; ++i) {
+    milkcat_parser_predict(parser, iterator, array[i].cstr);
+    status = milkcat_tokenbuf_drain(&tokens, iterator);
+    bounds[i + 1] = tokens.size;
+  }
+  Py_END_ALLOW_THREADS
+  if (status < 0) {
+    PyErr_NoMemory();
+  } else {
+    result = PyList_New(size);
+    for (i = 0; result && i < size; ++i) {
+      list = milkcat_tokenbuf_as_list(&tokens, bounds[i], bounds[i + 1]);
+      if (!list) Py_CLEAR(result);
+      else PyList_SET_ITEM(result, i, list);
+    }
+  }
+  milkcat_tokenbuf_free(&tokens);
+  free(bounds);
+  milkcat_texts_release(array, seq, size);
+  return result;
+}
+
+PyObject *
+milkcat_parser_predict_spans(milkcat_parser_t *parser,
+                             milkcat_parseriterator_t *iterator,
+                             PyObject *text,
+                             int codepoints)
+{
+  PyObject *result = NULL;
+  milkcat_text_t input;
+  milkcat_spanbuf_t spans;
+  int status;
+  if (milkcat_text_acquire(text, &input) < 0) return NULL;
+  memset(&spans, 0, sizeof(spans));
+  Py_BEGIN_ALLOW_THREADS
+  milkcat_parser_predict(parser, iterator, input.cstr);
+  status = milkcat_spanbuf_drain(&spans, iterator, input.cstr, (size_t)input.size, codepoints);
+  Py_END_ALLOW_THREADS
+  if (status < 0) {
+    PyErr_NoMemory();
+  } else {
+    result = PyBytes_FromStringAndSize((const char *)spans.spans, spans.size * sizeof(int));
+  }
+  free(spans.spans);
+  milkcat_text_release(&input);
+  return result;
+}
+
+PyObject *
+milkcat_parser_predict_into(milkcat_parser_t *parser,
+                            milkcat_parseriterator_t *iterator,
+                            PyObject *text,
+                            int offset,
+                            PyObject *heads_obj,
+                            PyObject *part_of_speech_tags_obj,
+                            PyObject *dependency_labels_obj,
+                            PyObject *spans_obj)
+{
+  PyObject *result = NULL;
+  milkcat_text_t input;
+  milkcat_array_t heads;
+  milkcat_array_t part_of_speech_tags;
+  milkcat_array_t dependency_labels;
+  milkcat_array_t spans;
+  milkcat_tokenbuf_t tokens;
+  milkcat_spancursor_t cursor;
+  milkcat_token_t *token;
+  int *ids = 0;
+  int span[2];
+  int status;
+  Py_ssize_t n, index;
+  size_t i;
+
+  memset(&input, 0, sizeof(input));
+  memset(&heads, 0, sizeof(heads));
+  memset(&part_of_speech_tags, 0, sizeof(part_of_speech_tags));
+  memset(&dependency_labels, 0, sizeof(dependency_labels));
+  memset(&spans, 0, sizeof(spans));
+  milkcat_tokenbuf_init(&tokens);
+  if (offset < 0) {
+    PyErr_SetString(PyExc_ValueError, "offset should not be negative");
+    goto fail;
+  }
+  if (milkcat_text_acquire(text, &input) < 0 ||
+      milkcat_array_acquire(heads_obj, &heads, "heads", 4, 8) < 0 ||
+      milkcat_array_acquire(part_of_speech_tags_obj, &part_of_speech_tags,
+                            "part_of_speech_tags", 1, 8) < 0 ||
+      milkcat_array_acquire(dependency_labels_obj, &dependency_labels,
+                            "dependency_labels", 1, 8) < 0 ||
+      milkcat_array_acquire(spans_obj, &spans, "spans", 4, 8) < 0) {
+    goto fail;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  milkcat_parser_predict(parser, iterator, input.cstr);
+  status = milkcat_tokenbuf_drain(&tokens, iterator);
+  Py_END_ALLOW_THREADS
+  if (status < 0) {
+    PyErr_NoMemory();
+    goto fail;
+  }
+  n = (Py_ssize_t)tokens.size;
+  if ((heads.has_view && offset + n > heads.size) ||
+      (part_of_speech_tags.has_view && offset + n > part_of_speech_tags.size) ||
+      (dependency_labels.has_view && offset + n > dependency_labels.size) ||
+      (spans.has_view && 2 * (offset + n) > spans.size)) {
+    PyErr_Format(PyExc_ValueError, "the arrays are too small for %d tokens at offset %d", (int)n, offset);
+    goto fail;
+  }
+  ids = (int *)calloc(tokens.tags_size + 1, sizeof(int));
+  if (!ids) {
+    PyErr_NoMemory();
+    goto fail;
+  }
+  for (i = 0; i < tokens.tags_size; ++i) {
+    ids[i] = milkcat_tag_id(tokens.tags[i]);
+    if (ids[i] < 0) {
+      PyErr_NoMemory();
+      goto fail;
+    }
+    if ((part_of_speech_tags.has_view && ids[i] > milkcat_array_max_id(&part_of_speech_tags)) ||
+        (dependency_labels.has_view && ids[i] > milkcat_array_max_id(&dependency_labels))) {
+      PyErr_Format(PyExc_OverflowError, "tag id %d does not fit into the tag arrays", ids[i]);
+      goto fail;
+    }
+  }
+  milkcat_spancursor_init(&cursor, input.cstr, (size_t)input.size, 1);
+  for (i = 0; i < tokens.size; ++i) {
+    token = tokens.tokens + i;
+    index = offset + (Py_ssize_t)i;
+    if (heads.has_view) milkcat_array_set(&heads, index, token->head);
+    if (part_of_speech_tags.has_view) {
+      milkcat_array_set(&part_of_speech_tags, index,
+                        token->part_of_speech_tag < 0 ? -1 : ids[token->part_of_speech_tag]);
+    }
+    if (dependency_labels.has_view) {
+      milkcat_array_set(&dependency_labels, index,
+                        token->dependency_label < 0 ? -1 : ids[token->dependency_label]);
+    }
+    if (spans.has_view) {
+      milkcat_spancursor_next(&cursor, tokens.arena + token->word, token->word_size, span);
+      milkcat_array_set(&spans, 2 * index, span[0]);
+      milkcat_array_set(&spans, 2 * index + 1, span[1]);
+    }
+  }
+  result = milkcat_int((long)n);
+fail:
+  free(ids);
+  milkcat_array_release(&heads);
+  milkcat_array_release(&part_of_speech_tags);
+  milkcat_array_release(&dependency_labels);
+  milkcat_array_release(&spans);
+  milkcat_tokenbuf_free(&tokens);
+  milkcat_text_release(&input);
+  return result;
+}
+
+PyObject *
+milkcat_batchengine_predict(milkcat_batchengine_t *engine,
+                            PyObject *texts,
+                            int split)
+{
+  PyObject *seq, *result = NULL;
+  Py_ssize_t size;
+  milkcat_text_t *array;
+  int status;
+  array = milkcat_texts_acquire(texts, &seq, &size);
+  if (!array) return NULL;
+  Py_BEGIN_ALLOW_THREADS
+  PyThread_acquire_lock(engine->busy, WAIT_LOCK);
+  status = milkcat_batchengine_run(engine, array, (size_t)size, split);
+  Py_END_ALLOW_THREADS
+  if (status < 0) {
+    PyErr_NoMemory();
+  } else {
+    result = milkcat_batchengine_results(engine, (size_t)size);
+  }
+  PyThread_release_lock(engine->busy);
+  milkcat_texts_release(array, seq, size);
+  return result;
+}
+
+PyObject *
+milkcat_parseriterator_drain(milkcat_parseriterator_t *iterator)
+{
+  PyObject *result = NULL;
+  milkcat_tokenbuf_t tokens;
+  int status;
+  milkcat_tokenbuf_init(&tokens);
+  Py_BEGIN_ALLOW_THREADS
+  status = milkcat_tokenbuf_drain(&tokens, iterator);
+  Py_END_ALLOW_THREADS
+  if (status < 0) PyErr_NoMemory();
+  else result = milkcat_tokenbuf_as_list(&tokens, 0, tokens.size);
+  milkcat_tokenbuf_free(&tokens);
+  return result;
+}
+
+PyObject *
+milkcat_parseriterator_drain_words(milkcat_parseriterator_t *iterator)
+{
+  PyObject *result = NULL;
+  milkcat_tokenbuf_t tokens;
+  int status;
+  milkcat_tokenbuf_init(&tokens);
+  Py_BEGIN_ALLOW_THREADS
+  status = milkcat_tokenbuf_drain(&tokens, iterator);
+  Py_END_ALLOW_THREADS
+  if (status < 0) PyErr_NoMemory();
+  else result = milkcat_tokenbuf_as_words(&tokens);
+  milkcat_tokenbuf_free(&tokens);
+  return result;
+}
+
+PyObject *
+milkcat_parseriterator_drain_packed(milkcat_parseriterator_t *iterator)
+{
+  PyObject *result = NULL;
+  milkcat_tokenbuf_t tokens;
+  int status;
+  milkcat_tokenbuf_init(&tokens);
+  Py_BEGIN_ALLOW_THREADS
+  status = milkcat_tokenbuf_drain(&tokens, iterator);
+  Py_END_ALLOW_THREADS
+  if (status < 0) PyErr_NoMemory();
+  else result = milkcat_tokenbuf_as_packed(&tokens);
+  milkcat_tokenbuf_free(&tokens);
+  return result;
+}
+
+PyObject *
+milkcat_parseriterator_next_sentence(milkcat_parseriterator_t *iterator,
+                                     int pending)
+{
+  PyObject *result = NULL;
+  milkcat_tokenbuf_t tokens;
+  int status, more = 0;
+  milkcat_tokenbuf_init(&tokens);
+  Py_BEGIN_ALLOW_THREADS
+  status = milkcat_tokenbuf_drain_sentence(&tokens, iterator, pending, &more);
+  Py_END_ALLOW_THREADS
+  if (status < 0) PyErr_NoMemory();
+  else result = milkcat_tokenbuf_as_list(&tokens, 0, tokens.size);
+  if (result) result = Py_BuildValue("(NN)", result, PyBool_FromLong(more));
+  milkcat_tokenbuf_free(&tokens);
+  return result;
+}
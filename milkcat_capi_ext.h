@@ -0,0 +1,139 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright 2013-2014 The MilkCat Project Developers
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * milkcat_capi_ext.h --- Created at 2026-10-17
+ *
+ * Functions of the _milkcat_capi module that are not part of libmilkcat:
+ * batch and zero-copy predictions and the native batch engine. They are
+ * wrapped by SWIG from milkcat_capi.i like the functions of milkcat.h, and
+ * must be called with the GIL held; they release it themselves while the
+ * library is working. Functions returning PyObject * return NULL with a
+ * Python exception set on failure.
+ */
+
+#ifndef MILKCAT_CAPI_EXT_H_
+#define MILKCAT_CAPI_EXT_H_
+
+#include <Python.h>
+#include <stdbool.h>
+#include <milkcat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SWIG
+
+/* The UTF-8 text handed to milkcat_parser_predict, read in place whenever
+   possible. Used by the typemaps of milkcat_capi.i. */
+typedef struct {
+  const char *cstr;
+  Py_ssize_t size;
+  PyObject *owner;
+  Py_buffer view;
+  int has_view;
+  char *copy;
+} milkcat_text_t;
+
+/* Takes the text of a str, bytes or buffer-protocol object. Returns 0 on
+   success, -1 with a Python exception set on failure. */
+int milkcat_text_acquire(PyObject *obj, milkcat_text_t *text);
+
+/* Releases a text taken by milkcat_text_acquire, or a zeroed one. */
+void milkcat_text_release(milkcat_text_t *text);
+
+#endif  /* SWIG */
+
+typedef struct milkcat_batchengine_t milkcat_batchengine_t;
+
+/* Predicts every text of the sequence texts, returns a list of
+   (word, part_of_speech_tag, head, dependency_label, is_begin_of_sentence)
+   tuple lists, one for each text. */
+PyObject *milkcat_parser_predict_batch(milkcat_parser_t *parser,
+                                       milkcat_parseriterator_t *iterator,
+                                       PyObject *texts);
+
+/* Predicts text, returns the (start, end) span of each word as native ints
+   in a bytes object, in code points when codepoints is set or else in bytes
+   of the UTF-8 text. */
+PyObject *milkcat_parser_predict_spans(milkcat_parser_t *parser,
+                                       milkcat_parseriterator_t *iterator,
+                                       PyObject *text,
+                                       int codepoints);
+
+/* Predicts text and writes the results of its i-th token into index
+   offset + i of the integer arrays heads, part_of_speech_tags and
+   dependency_labels and into 2 * (offset + i) and 2 * (offset + i) + 1 of
+   spans. None arrays are skipped. Returns the number of tokens. */
+PyObject *milkcat_parser_predict_into(milkcat_parser_t *parser,
+                                      milkcat_parseriterator_t *iterator,
+                                      PyObject *text,
+                                      int offset,
+                                      PyObject *heads,
+                                      PyObject *part_of_speech_tags,
+                                      PyObject *dependency_labels,
+                                      PyObject *spans);
+
+/* Creates an engine of size worker threads, each one with a parser built
+   from options. Returns NULL on failure, milkcat_last_error() tells why when
+   the failure comes from the library. Does not need the GIL. */
+milkcat_batchengine_t *milkcat_batchengine_new(milkcat_parseroptions_t *options,
+                                               int size);
+
+/* Stops the workers and frees the engine. Does not need the GIL. */
+void milkcat_batchengine_destroy(milkcat_batchengine_t *engine);
+
+/* Same as milkcat_parser_predict_batch, on the workers of engine. Each text
+   is handed to one worker as a whole, unless split is set: then texts are cut
+   at newlines and full width sentence terminators and the pieces are
+   predicted separately, which may give other results than predicting the
+   whole text wherever libmilkcat would not break there. */
+PyObject *milkcat_batchengine_predict(milkcat_batchengine_t *engine,
+                                      PyObject *texts,
+                                      int split);
+
+/* Returns all the remaining tokens of iterator as a list of tuples. */
+PyObject *milkcat_parseriterator_drain(milkcat_parseriterator_t *iterator);
+
+/* Returns the words of all the remaining tokens of iterator as a list of
+   str. */
+PyObject *milkcat_parseriterator_drain_words(milkcat_parseriterator_t *iterator);
+
+/* Returns all the remaining tokens of iterator as a (words, records) tuple
+   of two bytes objects, see milkcat_tokenbuf_as_packed. */
+PyObject *milkcat_parseriterator_drain_packed(milkcat_parseriterator_t *iterator);
+
+/* Returns a (tokens, more) tuple: the tokens of the next sentence of
+   iterator as a list of tuples and whether another sentence follows. pending
+   should be the more of the previous call, false for the first one. */
+PyObject *milkcat_parseriterator_next_sentence(milkcat_parseriterator_t *iterator,
+                                               int pending);
+
+/* Returns all the tags of the tag vocabulary as a list, indexed by id. */
+PyObject *milkcat_tag_vocabulary(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MILKCAT_CAPI_EXT_H_ */
@@ -0,0 +1,943 @@
+# -*- coding: utf-8 -*-
+#
+# The MIT License (MIT)
+#
+# Copyright 2013-2014 The MilkCat Project Developers
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# pymilkcat/__init__.py --- Created at 2014-02-20
+#
+
+import array
+import collections
+import contextlib
+import io
+import milkcat_capi
+import os
+import re
+import sys
+import tempfile
+import threading
+
+def _Text(text):
+    return text.decode('utf-8') if isinstance(text, bytes) else text
+
+def _WriteUserDictionary(out, userdict, words):
+    # Copies the lines of the user dictionary file userdict, except the ones
+    # of the words in words, then appends a "word [weight [pos_tag]]" line
+    # for each word added
+    if userdict:
+        with io.open(userdict, encoding = 'utf-8') as lines:
+            for line in lines:
+                fields = line.split()
+                if fields and fields[0] in words:
+                    continue
+                out.write(line.rstrip(u'\r\n') + u'\n')
+    for word, entry in words.items():
+        if entry is None:
+            continue
+        pos_tag, weight = entry
+        fields = [word]
+        if weight is not None:
+            fields.append(u'%s' % weight)
+        if pos_tag is not None:
+            fields.append(_Text(pos_tag))
+        out.write(u' '.join(fields) + u'\n')
+
+class _MemoryFile(object):
+    ''' Holds data in an anonymous in-memory file that libmilkcat could open
+    by path for as long as this object lives, falling back to a temporary
+    file where memfd_create is not available '''
+
+    def __init__(self, data):
+        self.data = data
+        self._temporary = not hasattr(os, 'memfd_create')
+        if self._temporary:
+            self._fd, self.path = tempfile.mkstemp(prefix = 'pymilkcat-')
+        else:
+            self._fd = os.memfd_create('pymilkcat')
+            self.path = '/proc/self/fd/%d' % self._fd
+        view = memoryview(data)
+        while view:
+            view = view[os.write(self._fd, view):]
+
+    def __del__(self):
+        os.close(self._fd)
+        if self._temporary:
+            os.unlink(self.path)
+
+def _UserDictionaryData(data):
+    # Returns the UTF-8 bytes of a user dictionary given as for
+    # ParserOptions.SetUserDictionaryData
+    if isinstance(data, bytes):
+        return data
+    if isinstance(data, type(u'')):
+        return data.encode('utf-8')
+    try:
+        return memoryview(data).tobytes()
+    except TypeError:
+        pass
+    words = collections.OrderedDict()
+    for word, pos_tag, weight in data:
+        if pos_tag is not None and weight is None:
+            raise ValueError('a pos_tag needs a weight')
+        words[_Text(word)] = (pos_tag, weight)
+    out = io.StringIO()
+    _WriteUserDictionary(out, None, words)
+    return out.getvalue().encode('utf-8')
+
+# Stages of the pipeline, to be or-ed together for the stages argument of
+# Parser.Predict, PredictTokens and PredictBatch
+SEGMENT = 1
+POS = 2
+DEPENDENCY = 4
+
+class ParserOptions:
+    ''' The options for Parser '''
+
+    def __init__(self):
+        self._options = milkcat_capi.milkcat_parseroptions_t()
+        milkcat_capi.milkcat_parseroptions_init(self._options)
+        self._userdict_file = None
+        self._result_cache_size = 0
+
+    def UseMixedSegmenter(self):
+        self._options.word_segmenter = milkcat_capi.MC_SEGMENTER_MIXED
+    def UseCRFSegmenter(self):
+        self._options.word_segmenter = milkcat_capi.MC_SEGMENTER_CRF
+    def UseBigramSegmenter(self):
+        self._options.word_segmenter = milkcat_capi.MC_SEGMENTER_BIGRAM
+
+    def UseMixedPOSTagger(self):
+        self._options.part_of_speech_tagger = milkcat_capi.MC_POSTAGGER_MIXED
+    def UseHMMPOSTagger(self):
+        self._options.part_of_speech_tagger = milkcat_capi.MC_POSTAGGER_HMM
+    def UseCRFPOSTagger(self):
+        self._options.part_of_speech_tagger = milkcat_capi.MC_POSTAGGER_CRF
+    def NoPOSTagger(self):
+        self._options.part_of_speech_tagger = milkcat_capi.MC_POSTAGGER_NONE
+
+    def UseYamadaParser(self):
+        self._options.dependency_parser = milkcat_capi.MC_DEPPARSER_YAMADA
+    def UseBeamYamadaParser(self):
+        self._options.dependency_parser = milkcat_capi.MC_DEPPARSER_BEAMYAMADA
+    def NoDependencyParser(self):
+        self._options.dependency_parser = milkcat_capi.MC_DEPPARSER_NONE
+
+    def SetUserDictionary(self, userdict):
+        self._options.user_dictionary_path = userdict
+        self._userdict_file = None
+    def SetUserDictionaryData(self, data):
+        ''' Sets the user dictionary from memory instead of a file. data is
+        either the content of a user dictionary file, as str or bytes-like
+        UTF-8, or an iterable of (word, pos_tag, weight) tuples where pos_tag
+        and weight could be None '''
+        self._userdict_file = _MemoryFile(_UserDictionaryData(data))
+        self._options.user_dictionary_path = self._userdict_file.path
+    def SetModelPath(self, model_path):
+        self._options.model_path = model_path
+
+    def SetResultCacheSize(self, max_bytes):
+        ''' Enables a cache of the results of Parser.Predict per sentence, up
+        to about max_bytes, for texts that repeat the same sentences. 0
+        disables it, which is the default.
+
+        With the cache, texts are split into sentences by pymilkcat, after
+        each of 。！？!? and newline, and every sentence is predicted on its
+        own. Where libmilkcat would find other sentence boundaries, the
+        results may differ from those without the cache '''
+        self._result_cache_size = max_bytes
+
+    _FIELDS = ('word_segmenter',
+               'part_of_speech_tagger',
+               'dependency_parser',
+               'user_dictionary_path',
+               'model_path')
+
+    def __getstate__(self):
+        state = dict((name, getattr(self._options, name))
+                     for name in self._FIELDS)
+        if self._userdict_file:
+            state['user_dictionary_path'] = None
+            state['user_dictionary_data'] = self._userdict_file.data
+        if self._result_cache_size:
+            state['result_cache_size'] = self._result_cache_size
+        return state
+
+    def __setstate__(self, state):
+        self.__init__()
+        for name, value in state.items():
+            if name == 'user_dictionary_data':
+                self.SetUserDictionaryData(value)
+            elif name == 'result_cache_size':
+                self.SetResultCacheSize(value)
+            elif value is not None:
+                setattr(self._options, name, value)
+
+class Item:
+    __slots__ = ('word',
+                 'part_of_speech_tag',
+                 'head',
+                 'dependency_label',
+                 'is_begin_of_sentence')
+
+    def __init__(self,
+                 word,
+                 part_of_speech_tag,
+                 head,
+                 dependency_label,
+                 is_begin_of_sentence):
+        self.word = word
+        self.part_of_speech_tag = part_of_speech_tag
+        self.head = head
+        self.dependency_label = dependency_label
+        self.is_begin_of_sentence = is_begin_of_sentence
+
+# Layout of the records of a token packed by
+# milkcat_parseriterator_drain_packed
+_PACKED_FIELDS = 6
+(_WORD,
+ _WORD_SIZE,
+ _PART_OF_SPEECH_TAG,
+ _HEAD,
+ _DEPENDENCY_LABEL,
+ _IS_BEGIN_OF_SENTENCE) = range(_PACKED_FIELDS)
+
+if sys.version_info >= (3, ):
+    def _Decode(data):
+        return data.decode('utf-8', 'surrogateescape')
+    def _IntArray(data):
+        records = array.array('i')
+        records.frombytes(data)
+        return records
+else:
+    def _Decode(data):
+        return data
+    def _IntArray(data):
+        records = array.array('i')
+        records.fromstring(data)
+        return records
+
+_tag_vocabulary = []
+
+def TagVocabulary():
+    ''' Returns all the part-of-speech tags and dependency labels known so far,
+    the index of a tag is its id. Ids are stable within a process, and the
+    Chinese Treebank tags and common dependency labels always come first in
+    the same order '''
+    global _tag_vocabulary
+    _tag_vocabulary = milkcat_capi.milkcat_tag_vocabulary()
+    return list(_tag_vocabulary)
+
+def _TagName(tag_id):
+    if tag_id < 0:
+        return None
+    if tag_id >= len(_tag_vocabulary):
+        TagVocabulary()
+    return _tag_vocabulary[tag_id]
+
+class TokenList(object):
+    ''' Tokens returned by Parser.PredictTokens. All the tokens are kept in
+    two packed buffers, their fields are decoded only when accessed. Tag ids
+    are resolved with vocabulary when given (e.g. the vocabulary of the
+    process that produced the buffers), otherwise with TagVocabulary() '''
+
+    def __init__(self, words, records, vocabulary = None):
+        self._words = words
+        self._records = _IntArray(records)
+        self._vocabulary = vocabulary
+
+    def __len__(self):
+        return len(self._records) // _PACKED_FIELDS
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            return [TokenView(self, i) for i in range(*index.indices(len(self)))]
+        if index < 0:
+            index += len(self)
+        if index < 0 or index >= len(self):
+            raise IndexError('token index out of range')
+        return TokenView(self, index)
+
+    def __iter__(self):
+        for index in range(len(self)):
+            yield TokenView(self, index)
+
+    def Word(self, index):
+        record = index * _PACKED_FIELDS
+        begin = self._records[record + _WORD]
+        end = begin + self._records[record + _WORD_SIZE]
+        return _Decode(self._words[begin: end])
+    def PartOfSpeechTagId(self, index):
+        return self._records[index * _PACKED_FIELDS + _PART_OF_SPEECH_TAG]
+    def PartOfSpeechTag(self, index):
+        return self._TagName(self.PartOfSpeechTagId(index))
+    def Head(self, index):
+        return self._records[index * _PACKED_FIELDS + _HEAD]
+    def DependencyLabelId(self, index):
+        return self._records[index * _PACKED_FIELDS + _DEPENDENCY_LABEL]
+    def DependencyLabel(self, index):
+        return self._TagName(self.DependencyLabelId(index))
+    def IsBeginOfSentence(self, index):
+        return bool(
+            self._records[index * _PACKED_FIELDS + _IS_BEGIN_OF_SENTENCE])
+
+    def Words(self):
+        return [self.Word(index) for index in range(len(self))]
+
+    def _TagName(self, tag_id):
+        if self._vocabulary is None or tag_id < 0:
+            return _TagName(tag_id)
+        return self._vocabulary[tag_id]
+
+class TokenView(object):
+    ''' One token of a TokenList, with the same attributes as Item '''
+    __slots__ = ('_tokens', '_index')
+
+    def __init__(self, tokens, index):
+        self._tokens = tokens
+        self._index = index
+
+    word = property(lambda self: self._tokens.Word(self._index))
+    part_of_speech_tag = property(
+        lambda self: self._tokens.PartOfSpeechTag(self._index))
+    head = property(lambda self: self._tokens.Head(self._index))
+    dependency_label = property(
+        lambda self: self._tokens.DependencyLabel(self._index))
+    is_begin_of_sentence = property(
+        lambda self: self._tokens.IsBeginOfSentence(self._index))
+
+# Characters that end a sentence, used to split streamed text without cutting
+# a sentence in half
+_SENTENCE_ENDS = u'\u3002\uff01\uff1f!?\n'
+_SENTENCE_ENDS_UTF8 = [c.encode('utf-8') for c in _SENTENCE_ENDS]
+
+def _SplitAfterLastSentence(text):
+    ''' Splits text into (complete sentences, remaining partial sentence) '''
+    ends = _SENTENCE_ENDS_UTF8 if isinstance(text, bytes) else _SENTENCE_ENDS
+    position = 0
+    for end in ends:
+        index = text.rfind(end)
+        if index >= 0:
+            position = max(position, index + len(end))
+    return text[: position], text[position: ]
+
+def _SplitAt(text, size):
+    ''' Splits text at about size without cutting a UTF-8 sequence '''
+    if isinstance(text, bytes):
+        while size > 0 and (ord(text[size: size + 1]) & 0xC0) == 0x80:
+            size -= 1
+    return text[: size], text[size: ]
+
+def _Chunks(readable, chunk_size):
+    if hasattr(readable, 'read'):
+        while True:
+            chunk = readable.read(chunk_size)
+            if not chunk:
+                return
+            yield chunk
+    else:
+        for chunk in readable:
+            yield chunk
+
+_SENTENCE_UTF8 = re.compile(
+    b'.*?(?:' + b'|'.join(re.escape(end) for end in _SENTENCE_ENDS_UTF8) + b'|$)',
+    re.S)
+
+def _SplitSentences(text):
+    ''' Splits text, a str or any bytes-like object holding UTF-8, after
+    every sentence end. Returns the sentences as UTF-8 bytes '''
+    if isinstance(text, type(u'')):
+        text = text.encode('utf-8')
+    return [sentence for sentence in _SENTENCE_UTF8.findall(text) if sentence]
+
+class _ResultCache(object):
+    ''' LRU cache of the tuples predicted for a sentence, bounded by an
+    estimate of the bytes they hold. Not thread safe '''
+
+    # Estimated bytes of a token tuple besides its word
+    _TOKEN_SIZE = 128
+
+    def __init__(self, max_bytes):
+        self.max_bytes = max_bytes
+        self.size = 0
+        self.hits = 0
+        self.misses = 0
+        self._entries = collections.OrderedDict()
+
+    def Get(self, key):
+        entry = self._entries.pop(key, None)
+        if entry is None:
+            self.misses += 1
+            return None
+        self._entries[key] = entry
+        self.hits += 1
+        return entry[0]
+
+    def Put(self, key, result):
+        size = len(key[1]) + sum(len(fields[0]) + self._TOKEN_SIZE
+                                 for fields in result)
+        if size > self.max_bytes:
+            return
+        if key in self._entries:
+            self.size -= self._entries.pop(key)[1]
+        self._entries[key] = (result, size)
+        self.size += size
+        while self.size > self.max_bytes:
+            _, (_, evicted) = self._entries.popitem(last = False)
+            self.size -= evicted
+
+    def Clear(self):
+        self._entries.clear()
+        self.size = 0
+
+    def Stats(self):
+        return {'hits': self.hits,
+                'misses': self.misses,
+                'entries': len(self._entries),
+                'bytes': self.size,
+                'max_bytes': self.max_bytes}
+
+class Parser:
+    ''' The GIL is released while the model is loaded and while a text is
+    predicted, so different Parser instances could run in parallel in
+    different threads. Calls on the same instance are serialized since they
+    share one iterator.
+
+    The text passed to Predict, PredictBatch and Break could be a str or any
+    bytes-like object holding UTF-8, both of them are read in place. '''
+
+    def __init__(self, options = ParserOptions()):
+        self._parser = milkcat_capi.milkcat_parser_new(options._options)
+        if self._parser == None:
+            raise Exception(milkcat_capi.milkcat_last_error())
+        self._iterator = milkcat_capi.milkcat_parseriterator_new()
+        self._lock = threading.Lock()
+        self._options = options.__getstate__()
+        self._reload_lock = threading.Lock()
+        # An in-memory user dictionary is kept open for reloads
+        self._userdict_file = options._userdict_file
+        if self._userdict_file:
+            del self._options['user_dictionary_data']
+            self._options['user_dictionary_path'] = self._userdict_file.path
+        self._userdict = self._options['user_dictionary_path']
+        # Words changed by AddWord and RemoveWord, mapped to (pos_tag, weight),
+        # or to None when removed
+        self._words = collections.OrderedDict()
+        # The stages run by _parser, and the native parsers running fewer
+        # stages, built on first use
+        self._stages = SEGMENT
+        if self._options['part_of_speech_tagger'] != milkcat_capi.MC_POSTAGGER_NONE:
+            self._stages |= POS
+        if self._options['dependency_parser'] != milkcat_capi.MC_DEPPARSER_NONE:
+            self._stages |= DEPENDENCY
+        self._natives = {}
+        # Native parsers read by Sentences generators, see _Pin
+        self._pins = {}
+        self._cache = None
+        if options._result_cache_size:
+            self._cache = _ResultCache(options._result_cache_size)
+
+    @contextlib.contextmanager
+    def _UserDictionary(self, userdict, words):
+        # Yields the path of the user dictionary userdict with words merged
+        # in, which stays valid within the block
+        if not words:
+            yield userdict
+            return
+        fd, path = tempfile.mkstemp(prefix = 'pymilkcat-', suffix = '.txt')
+        try:
+            with io.open(fd, 'w', encoding = 'utf-8') as out:
+                _WriteUserDictionary(out, userdict, words)
+            yield path
+        finally:
+            os.unlink(path)
+
+    def _NewNative(self, userdict, stages = None):
+        # Returns a new native parser with the options of this one and the
+        # user dictionary at userdict, running only stages when given
+        options = ParserOptions()
+        options.__setstate__(self._options)
+        if userdict is not None:
+            options.SetUserDictionary(userdict)
+        if stages is not None and not stages & POS:
+            options.NoPOSTagger()
+        if stages is not None and not stages & DEPENDENCY:
+            options.NoDependencyParser()
+        parser = milkcat_capi.milkcat_parser_new(options._options)
+        if parser == None:
+            raise Exception(milkcat_capi.milkcat_last_error())
+        return parser
+
+    def _Publish(self, userdict, words):
+        # Builds the native parsers with userdict plus words and swaps them
+        # in. Called with _reload_lock held
+        natives = {}
+        with self._UserDictionary(userdict, words) as path:
+            parser = self._NewNative(path)
+            try:
+                for stages in self._natives:
+                    natives[stages] = self._NewNative(path, stages)
+            except:
+                for native in [parser] + list(natives.values()):
+                    milkcat_capi.milkcat_parser_destroy(native)
+                raise
+        with self._lock:
+            old_parser, self._parser = self._parser, parser
+            old_natives, self._natives = self._natives, natives
+            if self._cache:
+                self._cache.Clear()
+            # A parser still read by a Sentences generator is destroyed by
+            # the generator once it is done
+            if id(old_parser) in self._pins:
+                self._pins[id(old_parser)][2] = True
+                old_parser = None
+        for native in [old_parser] + list(old_natives.values()):
+            if native != None:
+                milkcat_capi.milkcat_parser_destroy(native)
+
+    def _LoadStages(self, stages):
+        # Checks stages and loads a native parser running them if needed.
+        # Returns the key to pass to _Native
+        if stages is None or stages | SEGMENT == self._stages:
+            return None
+        stages |= SEGMENT
+        if stages & DEPENDENCY and not stages & POS:
+            raise ValueError('DEPENDENCY needs POS')
+        if stages & ~self._stages:
+            raise ValueError('stages not loaded by the options of this parser')
+        if stages not in self._natives:
+            with self._reload_lock:
+                if stages not in self._natives:
+                    with self._UserDictionary(self._userdict, self._words) as path:
+                        native = self._NewNative(path, stages)
+                    with self._lock:
+                        self._natives[stages] = native
+        return stages
+
+    def _Native(self, key):
+        # The native parser for a key returned by _LoadStages. Must be called
+        # with _lock held, since reloads replace the native parsers
+        return self._parser if key is None else self._natives[key]
+
+    def ReloadUserDictionary(self, userdict = None):
+        ''' Replaces the user dictionary by the one at userdict, or reads the
+        current one again when userdict is None. Words changed by AddWord and
+        RemoveWord stay changed. The new native parser is built without
+        holding the parser lock, so concurrent calls keep running on the old
+        one meanwhile; it is then swapped in between two calls and the old
+        one is destroyed. Raises on failure, in which case the old dictionary
+        stays in use.
+
+        libmilkcat has no way to replace only the dictionary of a parser, so
+        the models are loaded again by the new parser. '''
+        with self._reload_lock:
+            if userdict is None:
+                userdict = self._userdict
+            self._Publish(userdict, self._words)
+            if userdict != self._userdict:
+                self._userdict_file = None
+            self._userdict = userdict
+
+    def UpdateWords(self, added = (), removed = ()):
+        ''' Adds the (word, pos_tag, weight) of added and removes the words
+        of removed with a single reload, see ReloadUserDictionary. pos_tag and
+        weight could be None, but a pos_tag needs a weight '''
+        with self._reload_lock:
+            words = collections.OrderedDict(self._words)
+            for word, pos_tag, weight in added:
+                if pos_tag is not None and weight is None:
+                    raise ValueError('a pos_tag needs a weight')
+                words[_Text(word)] = (pos_tag, weight)
+            for word in removed:
+                words[_Text(word)] = None
+            self._Publish(self._userdict, words)
+            self._words = words
+
+    def AddWord(self, word, pos_tag = None, weight = None):
+        self.UpdateWords(added = [(word, pos_tag, weight)])
+
+    def RemoveWord(self, word):
+        self.UpdateWords(removed = [word])
+
+    def WriteUserDictionary(self, path):
+        ''' Writes the current user dictionary, with the changes of AddWord
+        and RemoveWord merged in, to path. It could then be passed to
+        SetUserDictionary or ReloadUserDictionary '''
+        with self._reload_lock:
+            with io.open(path, 'w', encoding = 'utf-8') as out:
+                _WriteUserDictionary(out, self._userdict, self._words)
+
+    def _Predict(self, text, stages = None):
+        # Returns the raw (word, part_of_speech_tag, head, dependency_label,
+        # is_begin_of_sentence) tuples built by milkcat_parseriterator_drain
+        key = self._LoadStages(stages)
+        if self._cache:
+            return self._PredictCached(text, key)
+        with self._lock:
+            milkcat_capi.milkcat_parser_predict(
+                self._Native(key),
+                self._iterator,
+                text)
+            return milkcat_capi.milkcat_parseriterator_drain(self._iterator)
+
+    def _PredictCached(self, text, key):
+        # Same as _Predict, looking up each sentence of text in the cache.
+        # The sentences missing from it are predicted in one batch. Keys are
+        # UTF-8 bytes, so a str and its encoding share one entry
+        sentences = _SplitSentences(text)
+        results = [None] * len(sentences)
+        with self._lock:
+            # Indexes of each missing sentence in sentences
+            missing = collections.OrderedDict()
+            for index, sentence in enumerate(sentences):
+                if sentence in missing:
+                    # Predicted only once, counts as a hit
+                    missing[sentence].append(index)
+                    self._cache.hits += 1
+                    continue
+                results[index] = self._cache.Get((key, sentence))
+                if results[index] is None:
+                    missing[sentence] = [index]
+            if missing:
+                batch = milkcat_capi.milkcat_parser_predict_batch(
+                    self._Native(key),
+                    self._iterator,
+                    list(missing))
+                for (sentence, indexes), result in zip(missing.items(), batch):
+                    for index in indexes:
+                        results[index] = result
+                    self._cache.Put((key, sentence), result)
+        return [fields for result in results for fields in result]
+
+    def CacheStats(self):
+        ''' Hits, misses, entries and bytes of the result cache enabled by
+        ParserOptions.SetResultCacheSize, None when it is disabled '''
+        if not self._cache:
+            return None
+        with self._lock:
+            return self._cache.Stats()
+
+    def Predict(self, text, stages = None):
+        ''' Returns the Item list of text. stages, e.g. SEGMENT | POS, runs
+        only some of the stages selected by the options. The first call with
+        some stages loads a native parser running only them '''
+        return [Item(*fields) for fields in self._Predict(text, stages)]
+
+    def Sentences(self, text):
+        ''' Generator of the sentences of text, each one a list of Item. A
+        sentence is yielded as soon as it is read from the iterator, before
+        the rest of text is processed. The generator has its own iterator
+        and only locks the parser while reading a sentence, so the parser
+        could be used, and reloaded, between two sentences '''
+        iterator = milkcat_capi.milkcat_parseriterator_new()
+        pinned = None
+        try:
+            with self._lock:
+                parser = self._parser
+                milkcat_capi.milkcat_parser_predict(parser, iterator, text)
+                self._Pin(parser)
+                pinned = parser
+            more = False
+            while True:
+                with self._lock:
+                    sentence, more = milkcat_capi.milkcat_parseriterator_next_sentence(
+                        iterator,
+                        more)
+                if sentence:
+                    yield [Item(*fields) for fields in sentence]
+                if not more:
+                    return
+        finally:
+            if pinned != None:
+                with self._lock:
+                    retired = self._Unpin(pinned)
+                if retired:
+                    milkcat_capi.milkcat_parser_destroy(pinned)
+            milkcat_capi.milkcat_parseriterator_destroy(iterator)
+
+    def __del__(self):
+        # Sentences generators keep the parser alive, nothing is pinned here
+        natives = [getattr(self, '_parser', None)]
+        natives += list(getattr(self, '_natives', {}).values())
+        for native in natives:
+            if native != None:
+                milkcat_capi.milkcat_parser_destroy(native)
+        if getattr(self, '_iterator', None) != None:
+            milkcat_capi.milkcat_parseriterator_destroy(self._iterator)
+
+    def _Pin(self, native):
+        # Keeps native from being destroyed by a reload while a generator
+        # reads from it. Called with _lock held
+        entry = self._pins.setdefault(id(native), [native, 0, False])
+        entry[1] += 1
+
+    def _Unpin(self, native):
+        # Returns True when native was retired by a reload while pinned and
+        # must now be destroyed by the caller. Called with _lock held
+        entry = self._pins[id(native)]
+        entry[1] -= 1
+        if entry[1]:
+            return False
+        del self._pins[id(native)]
+        return entry[2]
+
+    def _PredictPacked(self, text, stages = None):
+        # Returns the (words, records) bytes built by
+        # milkcat_parseriterator_drain_packed
+        key = self._LoadStages(stages)
+        with self._lock:
+            milkcat_capi.milkcat_parser_predict(
+                self._Native(key),
+                self._iterator,
+                text)
+            return milkcat_capi.milkcat_parseriterator_drain_packed(
+                self._iterator)
+
+    def PredictTokens(self, text, stages = None):
+        ''' Like Predict, but returns a TokenList, which decodes the fields
+        of a token only when they are accessed '''
+        words, records = self._PredictPacked(text, stages)
+        return TokenList(words, records)
+
+    def Spans(self, text):
+        ''' Returns the position of each word in text as an array of ints
+        [start_0, end_0, start_1, end_1, ...], in code points, without
+        building any string. A word not found in text (e.g. normalized by
+        the models) gets (-1, -1) '''
+        with self._lock:
+            spans = milkcat_capi.milkcat_parser_predict_spans(
+                self._parser,
+                self._iterator,
+                text,
+                True)
+        return _IntArray(spans)
+
+    def ByteSpans(self, text):
+        ''' Like Spans, but the positions are byte offsets into the UTF-8
+        encoded text '''
+        with self._lock:
+            spans = milkcat_capi.milkcat_parser_predict_spans(
+                self._parser,
+                self._iterator,
+                text,
+                False)
+        return _IntArray(spans)
+
+    def PredictInto(self,
+                    text,
+                    heads = None,
+                    part_of_speech_tags = None,
+                    dependency_labels = None,
+                    spans = None,
+                    offset = 0):
+        ''' Predicts text and writes the results of the i-th token into
+        index offset + i of preallocated integer arrays (array.array,
+        numpy.ndarray or any writable buffer): heads (32 or 64 bits),
+        part_of_speech_tags and dependency_labels (ids from TagVocabulary,
+        8 bits or wider, -1 or all bits set for a missing tag; an id that
+        does not fit, e.g. above 127 in int8, raises OverflowError) and
+        spans (32 or 64
+        bits, code point start and end at 2 * (offset + i) and
+        2 * (offset + i) + 1). Arrays passed as None are skipped. Returns the
+        number of tokens '''
+        with self._lock:
+            return milkcat_capi.milkcat_parser_predict_into(
+                self._parser,
+                self._iterator,
+                text,
+                offset,
+                heads,
+                part_of_speech_tags,
+                dependency_labels,
+                spans)
+
+    def PredictStream(self, readable, chunk_size = 65536, max_pending = 1 << 20):
+        ''' Generator of the Items of a text read incrementally from readable,
+        a file-like object (read in chunks of chunk_size) or an iterable of
+        chunks, either str or UTF-8 bytes. Only complete sentences are
+        predicted, the partial sentence at the end of a chunk is carried over
+        to the next one. A partial sentence longer than max_pending is cut,
+        so memory stays bounded whatever the size of the input '''
+        pending = None
+        for chunk in _Chunks(readable, chunk_size):
+            pending = chunk if pending is None else pending + chunk
+            text, pending = _SplitAfterLastSentence(pending)
+            if not text and len(pending) > max_pending:
+                text, pending = _SplitAt(pending, max_pending)
+            if text:
+                for fields in self._Predict(text):
+                    yield Item(*fields)
+        if pending:
+            for fields in self._Predict(pending):
+                yield Item(*fields)
+
+    def PredictBatch(self, texts, stages = None):
+        ''' Predicts a sequence of texts in one call, the GIL is released for
+        the whole batch. Returns a list of Item lists, one for each text.
+        stages is the same as for Predict '''
+        key = self._LoadStages(stages)
+        with self._lock:
+            batch = milkcat_capi.milkcat_parser_predict_batch(
+                self._Native(key),
+                self._iterator,
+                texts)
+        return [[Item(*fields) for fields in result] for result in batch]
+
+    def Break(self, text):
+        ''' Returns the words of text. Only the word segmenter runs: unless
+        the options of the parser already have neither a part-of-speech
+        tagger nor a dependency parser, a segmentation-only native parser is
+        loaded on the first call and used from then on '''
+        key = self._LoadStages(SEGMENT)
+        with self._lock:
+            milkcat_capi.milkcat_parser_predict(
+                self._Native(key),
+                self._iterator,
+                text)
+            return milkcat_capi.milkcat_parseriterator_drain_words(self._iterator)
+
+class ParserPool:
+    ''' A pool of Parser built from the same options, for sharing parsers
+    between threads. A thread checks a parser out with Acquire (or the
+    Parser context manager), uses it exclusively, and gives it back with
+    Release. Parsers are created lazily, at most size of them when size is
+    given, otherwise as many as there are concurrent users.
+
+    Note that every Parser still loads its own copy of the models, since
+    libmilkcat does not expose a model handle that could be shared between
+    parsers; the pool bounds and reuses them instead. '''
+
+    def __init__(self, options = ParserOptions(), size = None):
+        self._options = options
+        self._idle = []
+        self._lock = threading.Lock()
+        self._slots = threading.Semaphore(size) if size else None
+
+    def Acquire(self):
+        if self._slots:
+            self._slots.acquire()
+        try:
+            with self._lock:
+                if self._idle:
+                    return self._idle.pop()
+            return Parser(self._options)
+        except:
+            if self._slots:
+                self._slots.release()
+            raise
+
+    def Release(self, parser):
+        with self._lock:
+            self._idle.append(parser)
+        if self._slots:
+            self._slots.release()
+
+    @contextlib.contextmanager
+    def Parser(self):
+        parser = self.Acquire()
+        try:
+            yield parser
+        finally:
+            self.Release(parser)
+
+    def Predict(self, text):
+        with self.Parser() as parser:
+            return parser.Predict(text)
+
+    def Break(self, text):
+        with self.Parser() as parser:
+            return parser.Break(text)
+
+class BatchParser:
+    ''' Predicts batches of texts on a pool of native worker threads, each
+    one with its own parser. The texts are shared out between the workers and
+    an idle worker steals texts from the others. Python is never entered by
+    the workers and the GIL is released for the whole batch.
+
+    With split_sentences, texts are also cut after each newline, '。', '！'
+    and '？' and the pieces are shared out, so one long text in a batch of
+    short ones still keeps every thread busy. libmilkcat then predicts every
+    piece on its own: wherever it would not have broken the sentence there,
+    segmentation, heads and is_begin_of_sentence may differ from
+    Parser.PredictBatch.
+
+    Every worker loads its own copy of the models, as for ParserPool, so
+    memory grows linearly with threads; the default is kept small on purpose.
+    Batches on the same instance are serialized. '''
+
+    def __init__(self,
+                 options = ParserOptions(),
+                 threads = 2,
+                 split_sentences = False):
+        self._split_sentences = split_sentences
+        # Predictions in flight, Close waits for them before freeing the
+        # engine
+        self._condition = threading.Condition()
+        self._running = 0
+        self._engine = milkcat_capi.milkcat_batchengine_new(
+            options._options,
+            threads)
+        if self._engine == None:
+            raise Exception(milkcat_capi.milkcat_last_error())
+
+    def PredictBatch(self, texts):
+        ''' Returns a list of Item lists, one for each text. Unless
+        split_sentences is set, the same as Parser.PredictBatch '''
+        return self._Predict(texts, self._split_sentences)
+
+    def PredictSentences(self, sentences):
+        ''' Same as PredictBatch, except that the texts are never cut by
+        the binding, even with split_sentences: each text is handed to a
+        worker as a whole, which saves the sentence scan for short texts known
+        to be one sentence each. libmilkcat still looks for sentence
+        boundaries inside every text, and its is_begin_of_sentence and heads
+        are kept as they are '''
+        return self._Predict(sentences, False)
+
+    def _Predict(self, texts, split):
+        with self._condition:
+            engine = self._engine
+            if engine == None:
+                raise ValueError('BatchParser is closed')
+            self._running += 1
+        try:
+            batch = milkcat_capi.milkcat_batchengine_predict(engine, texts, split)
+        finally:
+            with self._condition:
+                self._running -= 1
+                self._condition.notify_all()
+        return [[Item(*fields) for fields in result] for result in batch]
+
+    def Close(self):
+        ''' Stops the worker threads and frees their parsers, once the
+        predictions already started by other threads are done '''
+        condition = getattr(self, '_condition', None)
+        if condition is None:
+            return
+        with condition:
+            engine, self._engine = self._engine, None
+            while self._running:
+                condition.wait()
+        if engine != None:
+            milkcat_capi.milkcat_batchengine_destroy(engine)
+
+    def __del__(self):
+        self.Close()
@@ -0,0 +1,151 @@
+# -*- coding: utf-8 -*-
+#
+# The MIT License (MIT)
+#
+# Copyright 2013-2014 The MilkCat Project Developers
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# aio.py --- Created at 2026-10-17
+#
+# asyncio front end of BatchParser (Python 3 only). The texts of all the
+# PredictAsync calls made in the same loop iteration are collected into one
+# batch, handed to a dispatcher thread and predicted by the native worker
+# pool of BatchParser with the GIL released. Results come back to the loop
+# through call_soon_threadsafe, which wakes the loop up through its self-pipe,
+# so the loop never blocks on the parser. Batches queued while another one is
+# running are merged before being predicted.
+#
+
+import asyncio
+import collections
+import threading
+
+import pymilkcat
+
+class AsyncParser:
+    ''' Awaitable parser for asyncio:
+
+        parser = AsyncParser()
+        items = await parser.PredictAsync(text)
+
+    PredictAsync could be called from any number of coroutines and event
+    loops, requests made in the same loop iteration are predicted together
+    in one batch. threads is the number of native workers of the underlying
+    BatchParser, each one loading its own copy of the models. '''
+
+    def __init__(self, options = pymilkcat.ParserOptions(), threads = 2):
+        self._parser = pymilkcat.BatchParser(options, threads)
+        # Requests of the current loop iteration, per loop
+        self._pending = {}
+        # Batches waiting for the dispatcher thread
+        self._queue = collections.deque()
+        self._condition = threading.Condition()
+        self._closed = False
+        self._dispatcher = threading.Thread(target = self._Dispatch)
+        self._dispatcher.daemon = True
+        self._dispatcher.start()
+
+    def PredictAsync(self, text):
+        ''' Returns a future of the Item list of text. Must be called from a
+        coroutine or a callback of a running event loop '''
+        if self._closed:
+            raise ValueError('AsyncParser is closed')
+        loop = asyncio.get_running_loop()
+        future = loop.create_future()
+        pending = self._pending.get(loop)
+        if pending is None:
+            pending = self._pending[loop] = []
+            loop.call_soon(self._Flush, loop)
+        pending.append((text, future))
+        return future
+
+    def _Flush(self, loop):
+        # Runs on the loop once the current iteration is over
+        batch = self._pending.pop(loop, None)
+        if not batch:
+            return
+        with self._condition:
+            if not self._closed:
+                self._queue.append((loop, batch))
+                self._condition.notify()
+                return
+        for _, future in batch:
+            if not future.cancelled():
+                future.set_exception(ValueError('AsyncParser is closed'))
+
+    def _Dispatch(self):
+        while True:
+            with self._condition:
+                while not self._queue and not self._closed:
+                    self._condition.wait()
+                if not self._queue:
+                    return
+                batches = list(self._queue)
+                self._queue.clear()
+            requests = [(loop, text, future)
+                        for loop, batch in batches
+                        for text, future in batch]
+            try:
+                results = self._parser.PredictBatch(
+                    [text for _, text, _ in requests])
+            except Exception:
+                # One bad text should not fail the requests batched with it
+                for loop, text, future in requests:
+                    try:
+                        result = self._parser.PredictBatch([text])[0]
+                    except Exception as e:
+                        self._Complete(loop, future, None, e)
+                    else:
+                        self._Complete(loop, future, result, None)
+                continue
+            for (loop, _, future), result in zip(requests, results):
+                self._Complete(loop, future, result, None)
+
+    @staticmethod
+    def _Complete(loop, future, result, exception):
+        def Set():
+            if future.cancelled():
+                return
+            if exception is not None:
+                future.set_exception(exception)
+            else:
+                future.set_result(result)
+        try:
+            loop.call_soon_threadsafe(Set)
+        except RuntimeError:
+            # The loop of the request is already closed
+            pass
+
+    def Close(self):
+        ''' Predicts the batches already queued, then stops the dispatcher
+        thread and the native workers '''
+        with self._condition:
+            if self._closed:
+                return
+            self._closed = True
+            self._condition.notify()
+        self._dispatcher.join()
+        self._parser.Close()
+
+    async def __aenter__(self):
+        return self
+
+    async def __aexit__(self, exc_type, exc_value, traceback):
+        await asyncio.get_running_loop().run_in_executor(None, self.Close)
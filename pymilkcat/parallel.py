@@ -0,0 +1,133 @@
+# -*- coding: utf-8 -*-
+#
+# The MIT License (MIT)
+#
+# Copyright 2013-2014 The MilkCat Project Developers
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# parallel.py --- Created at 2026-10-17
+#
+# Tags a corpus with a pool of processes. Where fork is available the models
+# are loaded once in the parent before the workers are forked, so all the
+# workers share one physical copy of them (copy-on-write). Results travel
+# back as the packed (words, records) bytes of milkcat_parseriterator_drain_packed
+# instead of pickled Item objects, and are exposed as TokenList. Tags outside
+# the builtin vocabulary may get different ids in different workers, so each
+# chunk carries the vocabulary of its worker.
+#
+
+import collections
+import multiprocessing
+
+import pymilkcat
+
+# The parser of a worker process, set by _Initialize or _Adopt when the
+# worker starts.
+_parser = None
+
+def _Initialize(options):
+    global _parser
+    _parser = pymilkcat.Parser(options)
+
+def _Adopt(parser):
+    # With fork the parser loaded by the parent is inherited, not pickled
+    global _parser
+    _parser = parser
+
+def _PredictChunk(texts):
+    results = [_parser._PredictPacked(text) for text in texts]
+    return results, pymilkcat.TagVocabulary()
+
+def _Chunks(texts, chunk_size):
+    chunk = []
+    for text in texts:
+        chunk.append(text)
+        if len(chunk) == chunk_size:
+            yield chunk
+            chunk = []
+    if chunk:
+        yield chunk
+
+def _Context():
+    if not hasattr(multiprocessing, 'get_context'):
+        return multiprocessing
+    if 'fork' in multiprocessing.get_all_start_methods():
+        return multiprocessing.get_context('fork')
+    return multiprocessing.get_context()
+
+class ParallelParser:
+    ''' Predicts texts with a pool of worker processes, each one with its own
+    Parser:
+
+        with pymilkcat.parallel.ParallelParser(options) as parser:
+            for tokens in parser.Predict(open('corpus.txt')):
+                ...
+
+    Texts are sent to the workers in chunks of chunk_size, and at most
+    max_pending chunks per process are in flight, so an arbitrarily large
+    corpus could be streamed through with bounded memory. Results are
+    yielded in the order of the input. '''
+
+    def __init__(self, options = None, processes = None):
+        options = options or pymilkcat.ParserOptions()
+        context = _Context()
+        processes = processes or multiprocessing.cpu_count()
+        if getattr(context, 'get_start_method', lambda: 'fork')() == 'fork':
+            # Load the models before forking, the workers inherit the parser.
+            # It is kept by the pool for the workers it forks again
+            self._pool = context.Pool(
+                processes,
+                _Adopt,
+                (pymilkcat.Parser(options), ))
+        else:
+            self._pool = context.Pool(processes, _Initialize, (options, ))
+        self._processes = processes
+
+    def Predict(self, texts, chunk_size = 256, max_pending = 2):
+        ''' Generator of one TokenList for each text of the iterable texts '''
+        pending = collections.deque()
+        for chunk in _Chunks(texts, chunk_size):
+            pending.append(self._pool.apply_async(_PredictChunk, (chunk, )))
+            while len(pending) >= self._processes * max_pending:
+                for tokens in self._Results(pending.popleft()):
+                    yield tokens
+        while pending:
+            for tokens in self._Results(pending.popleft()):
+                yield tokens
+
+    def _Results(self, result):
+        results, vocabulary = result.get()
+        for words, records in results:
+            yield pymilkcat.TokenList(words, records, vocabulary)
+
+    def Close(self):
+        ''' Waits for the workers to exit and frees the parser loaded by the
+        parent '''
+        if self._pool is None:
+            return
+        self._pool.close()
+        self._pool.join()
+        self._pool = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc_info):
+        self.Close()
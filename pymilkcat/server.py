@@ -0,0 +1,269 @@
+# -*- coding: utf-8 -*-
+#
+# The MIT License (MIT)
+#
+# Copyright 2013-2014 The MilkCat Project Developers
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# server.py --- Created at 2026-10-17
+#
+# A local prediction server with dynamic micro-batching. Requests of all the
+# connections are queued, and a batch is started as soon as max_batch_size
+# requests are waiting or the oldest of them has waited max_wait seconds, so
+# max_wait bounds the queueing delay added to a request while larger values
+# give larger batches under load. Batches run on the native worker pool of
+# BatchParser.
+#
+# The protocol is JSON lines over a Unix socket or a localhost TCP port. Each
+# request is either {"text": "..."}, answered by {"items": [[word,
+# part_of_speech_tag, head, dependency_label, is_begin_of_sentence], ...]},
+# or {"stats": true}, answered by the latency statistics of MicroBatcher.
+# Errors are answered by {"error": "..."}.
+#
+#   python3 -m pymilkcat.server --unix /tmp/milkcat.sock \
+#                               --max-batch-size 64 --max-wait 0.005
+#
+
+from __future__ import print_function
+
+import argparse
+import collections
+import json
+import os
+import stat
+import threading
+import time
+
+try:
+    import socketserver
+except ImportError:
+    import SocketServer as socketserver
+
+import pymilkcat
+
+class _Request:
+    __slots__ = ['text', 'arrival', 'done', 'result', 'error']
+
+    def __init__(self, text):
+        self.text = text
+        self.arrival = time.time()
+        self.done = threading.Event()
+        self.result = None
+        self.error = None
+
+def _Percentile(values, percent):
+    if not values:
+        return None
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * percent / 100.0))]
+
+class MicroBatcher:
+    ''' Collects the texts submitted by any number of threads into batches
+    of at most max_batch_size texts, waiting at most max_wait seconds after
+    the first text of a batch arrived. Latencies of the last window requests
+    are kept for Stats. threads is the number of native workers of the
+    underlying BatchParser, each one loading its own copy of the models. '''
+
+    def __init__(self,
+                 options = pymilkcat.ParserOptions(),
+                 max_batch_size = 64,
+                 max_wait = 0.005,
+                 threads = 2,
+                 window = 10000):
+        self.max_batch_size = max_batch_size
+        self.max_wait = max_wait
+        self._parser = pymilkcat.BatchParser(options, threads)
+        self._queue = collections.deque()
+        self._condition = threading.Condition()
+        self._closed = False
+        self._latencies = collections.deque(maxlen = window)
+        self._queue_delays = collections.deque(maxlen = window)
+        self._batch_sizes = collections.deque(maxlen = window)
+        self._requests = 0
+        self._batches = 0
+        self._worker = threading.Thread(target = self._Run)
+        self._worker.daemon = True
+        self._worker.start()
+
+    def Predict(self, text):
+        ''' Returns the Item list of text, blocks until its batch is done '''
+        request = _Request(text)
+        with self._condition:
+            if self._closed:
+                raise ValueError('MicroBatcher is closed')
+            self._queue.append(request)
+            self._condition.notify()
+        request.done.wait()
+        if request.error is not None:
+            raise request.error
+        return request.result
+
+    def _NextBatch(self):
+        with self._condition:
+            while not self._queue and not self._closed:
+                self._condition.wait()
+            if not self._queue:
+                return None
+            deadline = self._queue[0].arrival + self.max_wait
+            while len(self._queue) < self.max_batch_size and not self._closed:
+                timeout = deadline - time.time()
+                if timeout <= 0:
+                    break
+                self._condition.wait(timeout)
+            size = min(len(self._queue), self.max_batch_size)
+            return [self._queue.popleft() for _ in range(size)]
+
+    def _Run(self):
+        while True:
+            batch = self._NextBatch()
+            if batch is None:
+                return
+            start = time.time()
+            try:
+                results = self._parser.PredictBatch(
+                    [request.text for request in batch])
+            except Exception:
+                # Predicts one by one so that a bad text only fails itself
+                results = []
+                for request in batch:
+                    try:
+                        results.append(self._parser.PredictBatch([request.text])[0])
+                    except Exception as e:
+                        request.error = e
+                        results.append(None)
+            end = time.time()
+            for request, result in zip(batch, results):
+                request.result = result
+                self._latencies.append(end - request.arrival)
+                self._queue_delays.append(start - request.arrival)
+                request.done.set()
+            self._batch_sizes.append(len(batch))
+            self._requests += len(batch)
+            self._batches += 1
+
+    def Stats(self):
+        ''' Latency percentiles in seconds and mean batch size over the last
+        window requests, plus the totals since start '''
+        latencies = list(self._latencies)
+        queue_delays = list(self._queue_delays)
+        batch_sizes = list(self._batch_sizes)
+        return {
+            'requests': self._requests,
+            'batches': self._batches,
+            'max_batch_size': self.max_batch_size,
+            'max_wait': self.max_wait,
+            'latency_p50': _Percentile(latencies, 50),
+            'latency_p99': _Percentile(latencies, 99),
+            'queue_delay_p50': _Percentile(queue_delays, 50),
+            'queue_delay_p99': _Percentile(queue_delays, 99),
+            'mean_batch_size': (float(sum(batch_sizes)) / len(batch_sizes)
+                                if batch_sizes else None)}
+
+    def Close(self):
+        ''' Predicts the requests already queued, then stops the worker '''
+        with self._condition:
+            self._closed = True
+            self._condition.notify()
+        self._worker.join()
+        self._parser.Close()
+
+class _Handler(socketserver.StreamRequestHandler):
+    def handle(self):
+        batcher = self.server.batcher
+        for line in self.rfile:
+            if not line.strip():
+                continue
+            try:
+                request = json.loads(line.decode('utf-8'))
+                if request.get('stats'):
+                    response = batcher.Stats()
+                else:
+                    items = batcher.Predict(request['text'])
+                    response = {'items': [[item.word,
+                                           item.part_of_speech_tag,
+                                           item.head,
+                                           item.dependency_label,
+                                           item.is_begin_of_sentence]
+                                          for item in items]}
+            except Exception as e:
+                response = {'error': str(e)}
+            self.wfile.write(json.dumps(response).encode('utf-8') + b'\n')
+            self.wfile.flush()
+
+class _TCPServer(socketserver.ThreadingMixIn, socketserver.TCPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+if hasattr(socketserver, 'UnixStreamServer'):
+    class _UnixServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+        daemon_threads = True
+
+def MakeServer(batcher, unix_path = None, port = None, host = '127.0.0.1'):
+    ''' Returns a threading socketserver serving batcher on the Unix socket
+    unix_path, or else on host:port. A socket left at unix_path by a previous
+    server is removed, anything else there raises OSError. Run it with
+    serve_forever() '''
+    if unix_path:
+        try:
+            mode = os.lstat(unix_path).st_mode
+        except OSError:
+            mode = None
+        if mode is not None:
+            if not stat.S_ISSOCK(mode):
+                raise OSError('%s exists and is not a socket' % unix_path)
+            os.unlink(unix_path)
+        server = _UnixServer(unix_path, _Handler)
+    else:
+        server = _TCPServer((host, port), _Handler)
+    server.batcher = batcher
+    return server
+
+def Main():
+    parser = argparse.ArgumentParser(
+        description = 'Local pymilkcat server with dynamic micro-batching')
+    parser.add_argument('--unix', default = None, help = 'Unix socket path')
+    parser.add_argument('--port', type = int, default = 8300,
+                        help = 'localhost TCP port, when --unix is not given')
+    parser.add_argument('--max-batch-size', type = int, default = 64)
+    parser.add_argument('--max-wait', type = float, default = 0.005,
+                        help = 'seconds a request may wait for its batch')
+    parser.add_argument('--threads', type = int, default = 2,
+                        help = 'native workers, each one loads the models')
+    parser.add_argument('--model-path', default = None)
+    args = parser.parse_args()
+
+    options = pymilkcat.ParserOptions()
+    if args.model_path:
+        options.SetModelPath(args.model_path)
+    batcher = MicroBatcher(options,
+                           max_batch_size = args.max_batch_size,
+                           max_wait = args.max_wait,
+                           threads = args.threads)
+    server = MakeServer(batcher, unix_path = args.unix, port = args.port)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.server_close()
+        batcher.Close()
+
+if __name__ == '__main__':
+    Main()
@@ -1,11 +1,24 @@
 from distutils.core import setup, Extension
+from distutils.command.build import build
 
+# milkcat_capi_wrap.c and milkcat_capi.py are generated by SWIG from
+# milkcat_capi.i. Pass the directory of milkcat.h with
+# "build_ext --swig-opts=-I<dir> -I<dir>" when it is not /usr/local/include
 milkcat_capi = Extension('_milkcat_capi',
-	                       sources = ['milkcat_capi_wrap.c'],
+	                       sources = ['milkcat_capi.i', 'milkcat_capi_ext.c'],
+	                       swig_opts = ['-I/usr/local/include'],
 	                       libraries = ['milkcat'])
 
+class Build(build):
+    # build_ext runs SWIG, which writes milkcat_capi.py for build_py
+    sub_commands = ([('build_ext', build.has_ext_modules)] +
+                    [command for command in build.sub_commands
+                     if command[0] != 'build_ext'])
+
 setup (name = 'pymilkcat',
        version = '1.0',
-       py_modules = ['pymilkcat', 'milkcat_capi'],
+       packages = ['pymilkcat'],
+       py_modules = ['milkcat_capi'],
        description = 'Python interface for MilkCat - A Chinese NLP toolkit',
-       ext_modules = [milkcat_capi])
+       ext_modules = [milkcat_capi],
+       cmdclass = {'build': Build})